@@ -0,0 +1,152 @@
+# Generates bxImGuiIcons.h: the glyph ranges of the ICON_FA_ names the
+# sources use and, when a font and fontTools are given, that font subset to
+# those glyphs as an embedded array. Script mode:
+#
+#   cmake -DSOURCE_LIST=<file listing sources, one per line>
+#         -DICON_HEADER=<IconsFontAwesome5.h> -DOUTPUT=<header> -DSTAMP=<file>
+#         [-DPYTHON=<python with fontTools> -DICON_FONT=<ttf>]
+#         -P IconSubset.cmake
+#
+# The header is only rewritten when its content changes, so editing a source
+# without touching its icons recompiles nothing.
+
+cmake_minimum_required(VERSION 3.19)
+
+# Every ICON_FA_ name in the sources
+file(STRINGS "${SOURCE_LIST}" _sources)
+set(_names)
+foreach(_source IN LISTS _sources)
+    if(NOT EXISTS "${_source}")
+        continue()
+    endif()
+    file(STRINGS "${_source}" _lines REGEX "ICON_FA_[A-Z0-9_]+")
+    foreach(_line IN LISTS _lines)
+        string(REGEX MATCHALL "ICON_FA_[A-Z0-9_]+" _found "${_line}")
+        list(APPEND _names ${_found})
+    endforeach()
+endforeach()
+list(REMOVE_DUPLICATES _names)
+
+# Codepoints from the defines' UTF-8 literals, e.g. "\xef\x81\x98"
+file(STRINGS "${ICON_HEADER}" _defines REGEX "^#define ICON_")
+foreach(_define IN LISTS _defines)
+    if(_define MATCHES "^#define (ICON_FA_[A-Z0-9_]+)[ \t]+\"\\\\x([0-9a-fA-F][0-9a-fA-F])\\\\x([0-9a-fA-F][0-9a-fA-F])\\\\x([0-9a-fA-F][0-9a-fA-F])\"")
+        math(EXPR _cp "((0x${CMAKE_MATCH_2} & 0x0F) << 12) | ((0x${CMAKE_MATCH_3} & 0x3F) << 6) | (0x${CMAKE_MATCH_4} & 0x3F)")
+        set(_cp_${CMAKE_MATCH_1} ${_cp})
+    elseif(_define MATCHES "^#define ICON_MIN_FA[ \t]+0x([0-9a-fA-F]+)")
+        math(EXPR _min_fa "0x${CMAKE_MATCH_1}")
+    elseif(_define MATCHES "^#define ICON_MAX_16_FA[ \t]+0x([0-9a-fA-F]+)")
+        math(EXPR _max_fa "0x${CMAKE_MATCH_1}")
+    endif()
+endforeach()
+
+set(_codepoints)
+foreach(_name IN LISTS _names)
+    if(DEFINED _cp_${_name})
+        list(APPEND _codepoints ${_cp_${_name}})
+    else()
+        message(WARNING "IconSubset: ${_name} is not a 3-byte icon in ${ICON_HEADER}")
+    endif()
+endforeach()
+list(REMOVE_DUPLICATES _codepoints)
+list(SORT _codepoints COMPARE NATURAL)
+list(LENGTH _codepoints _count)
+
+# Consecutive codepoints share a range
+set(_ranges)
+set(_first "")
+set(_last "")
+foreach(_cp IN LISTS _codepoints)
+    if(NOT _first STREQUAL "")
+        math(EXPR _next "${_last} + 1")
+        if(_cp EQUAL _next)
+            set(_last ${_cp})
+            continue()
+        endif()
+        list(APPEND _ranges "${_first}-${_last}")
+    endif()
+    set(_first ${_cp})
+    set(_last ${_cp})
+endforeach()
+if(NOT _first STREQUAL "")
+    list(APPEND _ranges "${_first}-${_last}")
+endif()
+if(NOT _ranges)
+    # Nothing used: keep the whole range rather than an empty font
+    list(APPEND _ranges "${_min_fa}-${_max_fa}")
+endif()
+
+set(_table "")
+set(_unicodes "")
+foreach(_range IN LISTS _ranges)
+    string(REPLACE "-" ";" _bounds "${_range}")
+    list(GET _bounds 0 _begin)
+    list(GET _bounds 1 _end)
+    math(EXPR _begin_hex "${_begin}" OUTPUT_FORMAT HEXADECIMAL)
+    math(EXPR _end_hex "${_end}" OUTPUT_FORMAT HEXADECIMAL)
+    string(APPEND _table "\t${_begin_hex}, ${_end_hex},\n")
+    string(REPLACE "0x" "" _begin_bare "${_begin_hex}")
+    string(REPLACE "0x" "" _end_bare "${_end_hex}")
+    if(_unicodes)
+        string(APPEND _unicodes ",")
+    endif()
+    if(_begin EQUAL _end)
+        string(APPEND _unicodes "${_begin_bare}")
+    else()
+        string(APPEND _unicodes "${_begin_bare}-${_end_bare}")
+    endif()
+endforeach()
+
+set(_content "// Generated by cmake/IconSubset.cmake from the ICON_FA_ names used in the
+// sources; do not edit.
+#pragma once
+
+#include <imgui.h>
+
+#define BXIMGUI_ICON_COUNT ${_count}
+
+static const ImWchar kIconGlyphRanges[] = {
+${_table}\t0,
+};
+")
+
+# The font itself, cut down to those glyphs
+if(PYTHON AND ICON_FONT AND EXISTS "${ICON_FONT}")
+    get_filename_component(_work_dir "${OUTPUT}" DIRECTORY)
+    set(_subset "${_work_dir}/fa-solid-subset.ttf")
+    file(MAKE_DIRECTORY "${_work_dir}")
+    execute_process(
+        COMMAND "${PYTHON}" -m fontTools.subset "${ICON_FONT}"
+                "--unicodes=${_unicodes}" "--output-file=${_subset}"
+                --no-hinting
+        RESULT_VARIABLE _subset_result
+        ERROR_VARIABLE _subset_error)
+    if(_subset_result EQUAL 0 AND EXISTS "${_subset}")
+        file(READ "${_subset}" _hex HEX)
+        file(SIZE "${_subset}" _size)
+        string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," _bytes "${_hex}")
+        # 16 bytes per line (CMake regexes have no {n})
+        string(REPEAT "0x[0-9a-f][0-9a-f]," 16 _line_pattern)
+        string(REGEX REPLACE "(${_line_pattern})" "\\1\n\t" _bytes
+               "${_bytes}")
+        string(APPEND _content "
+// ${ICON_FONT}, ${_size} bytes after subsetting
+#define BXIMGUI_EMBEDDED_ICON_FONT 1
+static const unsigned char kIconFontData[] = {
+\t${_bytes}
+};
+")
+    else()
+        message(WARNING "IconSubset: subsetting ${ICON_FONT} failed; the "
+                        "font is loaded from disk at runtime\n${_subset_error}")
+    endif()
+endif()
+
+set(_old "")
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" _old)
+endif()
+if(NOT _old STREQUAL _content)
+    file(WRITE "${OUTPUT}" "${_content}")
+endif()
+file(TOUCH "${STAMP}")
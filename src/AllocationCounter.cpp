@@ -0,0 +1,113 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace blot {
+
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_frees{0};
+std::atomic<uint64_t> g_bytes{0};
+thread_local AllocationCounter::Counts t_counts;
+thread_local AllocationCounter::Counts t_frameStart;
+thread_local AllocationCounter::Counts t_lastFrame;
+} // namespace
+
+void AllocationCounter::recordAllocation(size_t bytes) {
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	g_bytes.fetch_add(bytes, std::memory_order_relaxed);
+	t_counts.allocations++;
+	t_counts.bytes += bytes;
+}
+
+void AllocationCounter::recordFree() {
+	g_frees.fetch_add(1, std::memory_order_relaxed);
+	t_counts.frees++;
+}
+
+AllocationCounter::Counts AllocationCounter::threadCounts() {
+	return t_counts;
+}
+
+AllocationCounter::Counts AllocationCounter::globalCounts() {
+	Counts counts;
+	counts.allocations = g_allocations.load(std::memory_order_relaxed);
+	counts.frees = g_frees.load(std::memory_order_relaxed);
+	counts.bytes = g_bytes.load(std::memory_order_relaxed);
+	return counts;
+}
+
+void AllocationCounter::beginFrame() { t_frameStart = t_counts; }
+
+void AllocationCounter::endFrame() {
+	t_lastFrame.allocations = t_counts.allocations - t_frameStart.allocations;
+	t_lastFrame.frees = t_counts.frees - t_frameStart.frees;
+	t_lastFrame.bytes = t_counts.bytes - t_frameStart.bytes;
+}
+
+AllocationCounter::Counts AllocationCounter::lastFrameCounts() {
+	return t_lastFrame;
+}
+
+bool AllocationCounter::isOperatorNewHooked() {
+#ifdef BXIMGUI_COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+} // namespace blot
+
+#ifdef BXIMGUI_COUNT_ALLOCATIONS
+// Counting replacements of the global allocation functions. Aligned variants
+// keep the standard library implementation.
+static void *countedNew(size_t size) {
+	blot::AllocationCounter::recordAllocation(size);
+	if (size == 0)
+		size = 1;
+	while (true) {
+		if (void *ptr = std::malloc(size))
+			return ptr;
+		std::new_handler handler = std::get_new_handler();
+		if (!handler)
+			throw std::bad_alloc();
+		handler();
+	}
+}
+
+static void countedDelete(void *ptr) noexcept {
+	if (!ptr)
+		return;
+	blot::AllocationCounter::recordFree();
+	std::free(ptr);
+}
+
+void *operator new(size_t size) { return countedNew(size); }
+void *operator new[](size_t size) { return countedNew(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+	try {
+		return countedNew(size);
+	} catch (...) {
+		return nullptr;
+	}
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+	try {
+		return countedNew(size);
+	} catch (...) {
+		return nullptr;
+	}
+}
+void operator delete(void *ptr) noexcept { countedDelete(ptr); }
+void operator delete[](void *ptr) noexcept { countedDelete(ptr); }
+void operator delete(void *ptr, size_t) noexcept { countedDelete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { countedDelete(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+	countedDelete(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+	countedDelete(ptr);
+}
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace blot {
+
+// Heap allocation accounting. Counts are fed by ImGuiAllocator (installed in
+// Mui::initImGui()) and, when the addon is built with
+// BXIMGUI_COUNT_ALLOCATIONS, by replacements of the global operator new and
+// delete. Per-thread counts let the UI thread measure its own frames while
+// worker threads keep allocating.
+class AllocationCounter {
+  public:
+	struct Counts {
+		uint64_t allocations = 0;
+		uint64_t frees = 0;
+		uint64_t bytes = 0;
+	};
+
+	static void recordAllocation(size_t bytes);
+	static void recordFree();
+
+	// Counts of the calling thread / of the whole process
+	static Counts threadCounts();
+	static Counts globalCounts();
+
+	// Frame bracketing for the calling thread; Mui calls these around every
+	// frame it builds so lastFrameCounts() reports what that frame allocated
+	static void beginFrame();
+	static void endFrame();
+	static Counts lastFrameCounts();
+
+	// True when operator new/delete are being counted
+	static bool isOperatorNewHooked();
+};
+
+} // namespace blot
@@ -0,0 +1,540 @@
+#include "CommandRegistry.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <exception>
+#include <iterator>
+
+namespace blot {
+
+static std::string toLower(std::string text) {
+	std::transform(text.begin(), text.end(), text.begin(), [](char c) {
+		return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	});
+	return text;
+}
+
+static bool parseInt(const std::string &text, long long &value) {
+	if (text.empty())
+		return false;
+	char *end = nullptr;
+	errno = 0;
+	value = std::strtoll(text.c_str(), &end, 0);
+	return errno == 0 && *end == '\0';
+}
+
+static bool parseFloat(const std::string &text, double &value) {
+	if (text.empty())
+		return false;
+	char *end = nullptr;
+	errno = 0;
+	value = std::strtod(text.c_str(), &end);
+	return errno == 0 && *end == '\0';
+}
+
+static bool parseBool(const std::string &text, bool &value) {
+	const std::string lower = toLower(text);
+	if (lower == "1" || lower == "true" || lower == "on" || lower == "yes") {
+		value = true;
+		return true;
+	}
+	if (lower == "0" || lower == "false" || lower == "off" || lower == "no") {
+		value = false;
+		return true;
+	}
+	return false;
+}
+
+// PrefixTrie
+
+void PrefixTrie::insert(const std::string &word) {
+	if (contains(word))
+		return;
+	uint32_t node = 0;
+	m_nodes[0].words++;
+	for (char c : word) {
+		auto &children = m_nodes[node].children;
+		auto it = std::lower_bound(
+			children.begin(), children.end(), c,
+			[](const std::pair<char, uint32_t> &child, char key) {
+				return child.first < key;
+			});
+		if (it == children.end() || it->first != c) {
+			const uint32_t child = static_cast<uint32_t>(m_nodes.size());
+			// children may move when m_nodes grows; insert before push_back
+			children.insert(it, {c, child});
+			m_nodes.emplace_back();
+			node = child;
+		} else {
+			node = it->second;
+		}
+		m_nodes[node].words++;
+	}
+	m_nodes[node].terminal = true;
+	m_size++;
+}
+
+bool PrefixTrie::erase(const std::string &word) {
+	if (!contains(word))
+		return false;
+	// Nodes stay allocated; subtrees with no words are skipped on lookup
+	uint32_t node = 0;
+	m_nodes[0].words--;
+	for (char c : word) {
+		for (const auto &child : m_nodes[node].children) {
+			if (child.first == c) {
+				node = child.second;
+				break;
+			}
+		}
+		m_nodes[node].words--;
+	}
+	m_nodes[node].terminal = false;
+	m_size--;
+	return true;
+}
+
+bool PrefixTrie::contains(const std::string &word) const {
+	int node = findNode(word);
+	return node >= 0 && m_nodes[node].terminal;
+}
+
+void PrefixTrie::clear() {
+	m_nodes.assign(1, Node());
+	m_size = 0;
+}
+
+int PrefixTrie::findNode(const std::string &prefix) const {
+	uint32_t node = 0;
+	for (char c : prefix) {
+		const auto &children = m_nodes[node].children;
+		auto it = std::lower_bound(
+			children.begin(), children.end(), c,
+			[](const std::pair<char, uint32_t> &child, char key) {
+				return child.first < key;
+			});
+		if (it == children.end() || it->first != c)
+			return -1;
+		node = it->second;
+	}
+	return m_nodes[node].words > 0 ? static_cast<int>(node) : -1;
+}
+
+void PrefixTrie::collect(uint32_t node, std::string &word,
+						 std::vector<std::string> &out,
+						 size_t maxResults) const {
+	if (m_nodes[node].terminal) {
+		if (out.size() >= maxResults)
+			return;
+		out.push_back(word);
+	}
+	for (const auto &child : m_nodes[node].children) {
+		if (out.size() >= maxResults)
+			return;
+		if (m_nodes[child.second].words == 0)
+			continue;
+		word.push_back(child.first);
+		collect(child.second, word, out, maxResults);
+		word.pop_back();
+	}
+}
+
+size_t PrefixTrie::complete(const std::string &prefix,
+							std::vector<std::string> &out,
+							size_t maxResults) const {
+	int node = findNode(prefix);
+	if (node < 0 || maxResults == 0)
+		return 0;
+	const size_t before = out.size();
+	std::string word = prefix;
+	collect(static_cast<uint32_t>(node), word, out, before + maxResults);
+	return out.size() - before;
+}
+
+std::string PrefixTrie::commonPrefix(const std::string &prefix) const {
+	int found = findNode(prefix);
+	if (found < 0)
+		return prefix;
+	std::string result = prefix;
+	uint32_t node = static_cast<uint32_t>(found);
+	// Walk down while exactly one populated child continues every word
+	while (!m_nodes[node].terminal) {
+		const std::pair<char, uint32_t> *next = nullptr;
+		for (const auto &child : m_nodes[node].children) {
+			if (m_nodes[child.second].words == 0)
+				continue;
+			if (next)
+				return result;
+			next = &child;
+		}
+		if (!next)
+			break;
+		result.push_back(next->first);
+		node = next->second;
+	}
+	return result;
+}
+
+// Command
+
+std::string Command::usage() const {
+	std::string text = name;
+	for (const CommandArg &arg : args) {
+		const char *suffix = arg.type == CommandArg::Type::Rest ? "..." : "";
+		text += arg.optional ? " [" : " <";
+		text += arg.name + suffix;
+		text += arg.optional ? "]" : ">";
+	}
+	return text;
+}
+
+// CommandContext
+
+const std::string &CommandContext::arg(size_t index) const {
+	static const std::string kEmpty;
+	return index < m_args.size() ? m_args[index] : kEmpty;
+}
+
+long long CommandContext::getInt(size_t index, long long fallback) const {
+	long long value = 0;
+	return has(index) && parseInt(m_args[index], value) ? value : fallback;
+}
+
+double CommandContext::getFloat(size_t index, double fallback) const {
+	double value = 0.0;
+	return has(index) && parseFloat(m_args[index], value) ? value : fallback;
+}
+
+bool CommandContext::getBool(size_t index, bool fallback) const {
+	bool value = false;
+	return has(index) && parseBool(m_args[index], value) ? value : fallback;
+}
+
+void CommandContext::print(std::string line) {
+	if (m_runner)
+		m_runner->push(m_generation, std::move(line), false);
+}
+
+void CommandContext::error(std::string line) {
+	if (m_runner)
+		m_runner->push(m_generation, std::move(line), true);
+}
+
+bool CommandContext::isCancelled() const {
+	return !m_runner || m_runner->m_generation.load() != m_generation;
+}
+
+// CommandRegistry
+
+bool CommandRegistry::add(Command command, std::string *error) {
+	auto fail = [error](std::string reason) {
+		if (error)
+			*error = std::move(reason);
+		return false;
+	};
+	command.name = toLower(command.name);
+	for (std::string &alias : command.aliases)
+		alias = toLower(alias);
+
+	std::vector<std::string> names = command.aliases;
+	names.push_back(command.name);
+	for (const std::string &name : names) {
+		if (name.empty())
+			return fail("Command names must not be empty");
+		for (char c : name) {
+			if (std::isspace(static_cast<unsigned char>(c)) || c == '"')
+				return fail("Invalid command name '" + name + "'");
+		}
+		if (m_names.contains(name))
+			return fail("Command '" + name + "' is already registered");
+	}
+	if (!command.handler)
+		return fail("Command '" + command.name + "' has no handler");
+	bool optionalSeen = false;
+	for (size_t i = 0; i < command.args.size(); i++) {
+		const CommandArg &arg = command.args[i];
+		if (arg.type == CommandArg::Type::Rest && i + 1 != command.args.size())
+			return fail("'" + arg.name + "' must be the last argument");
+		if (optionalSeen && !arg.optional)
+			return fail("Required argument '" + arg.name +
+						"' follows an optional one");
+		optionalSeen = optionalSeen || arg.optional;
+	}
+
+	for (const std::string &name : names)
+		m_names.insert(name);
+	for (const std::string &alias : command.aliases)
+		m_aliases[alias] = command.name;
+	std::string name = command.name;
+	m_commands.emplace(std::move(name), std::move(command));
+	return true;
+}
+
+bool CommandRegistry::remove(const std::string &name) {
+	const Command *command = find(name);
+	if (!command)
+		return false;
+	for (const std::string &alias : command->aliases) {
+		m_aliases.erase(alias);
+		m_names.erase(alias);
+	}
+	m_names.erase(command->name);
+	m_commands.erase(command->name);
+	return true;
+}
+
+const Command *CommandRegistry::find(const std::string &name) const {
+	std::string key = toLower(name);
+	auto alias = m_aliases.find(key);
+	if (alias != m_aliases.end())
+		key = alias->second;
+	auto it = m_commands.find(key);
+	return it != m_commands.end() ? &it->second : nullptr;
+}
+
+std::vector<const Command *> CommandRegistry::list() const {
+	std::vector<const Command *> commands;
+	commands.reserve(m_commands.size());
+	for (const auto &entry : m_commands)
+		commands.push_back(&entry.second);
+	std::sort(commands.begin(), commands.end(),
+			  [](const Command *a, const Command *b) {
+				  return a->name < b->name;
+			  });
+	return commands;
+}
+
+std::vector<std::string> CommandRegistry::tokenize(const std::string &line,
+												  std::vector<size_t> *starts) {
+	std::vector<std::string> tokens;
+	std::string token;
+	bool inToken = false;
+	bool quoted = false;
+	for (size_t i = 0; i < line.size(); i++) {
+		const char c = line[i];
+		const bool space = std::isspace(static_cast<unsigned char>(c)) != 0;
+		if (!inToken && !space && starts)
+			starts->push_back(i);
+		// Backslash escapes only what tokenizing consumes, so paths survive
+		const char next = i + 1 < line.size() ? line[i + 1] : '\0';
+		if (c == '\\' && (next == '"' || next == '\\' ||
+						   std::isspace(static_cast<unsigned char>(next)))) {
+			token += line[++i];
+			inToken = true;
+		} else if (c == '"') {
+			quoted = !quoted;
+			inToken = true;
+		} else if (!quoted && space) {
+			if (inToken)
+				tokens.push_back(std::move(token));
+			token.clear();
+			inToken = false;
+		} else {
+			token += c;
+			inToken = true;
+		}
+	}
+	if (inToken)
+		tokens.push_back(std::move(token));
+	return tokens;
+}
+
+bool CommandRegistry::parse(const std::string &line, const Command *&command,
+							std::vector<std::string> &args,
+							std::string &error) const {
+	std::vector<size_t> starts;
+	args = tokenize(line, &starts);
+	command = nullptr;
+	error.clear();
+	if (args.empty())
+		return false;
+	command = find(args[0]);
+	if (!command) {
+		error = "Unknown command: '" + args[0] + "'";
+		return false;
+	}
+	args.erase(args.begin());
+	starts.erase(starts.begin());
+
+	const std::vector<CommandArg> &schema = command->args;
+	for (size_t i = 0; i < schema.size(); i++) {
+		const CommandArg &spec = schema[i];
+		if (i >= args.size()) {
+			if (spec.optional)
+				break;
+			error = "Missing argument '" + spec.name + "'";
+			return false;
+		}
+		const std::string &value = args[i];
+		bool valid = true;
+		switch (spec.type) {
+		case CommandArg::Type::Int: {
+			long long parsed = 0;
+			valid = parseInt(value, parsed);
+			break;
+		}
+		case CommandArg::Type::Float: {
+			double parsed = 0.0;
+			valid = parseFloat(value, parsed);
+			break;
+		}
+		case CommandArg::Type::Bool: {
+			bool parsed = false;
+			valid = parseBool(value, parsed);
+			break;
+		}
+		case CommandArg::Type::Rest: {
+			size_t end = line.find_last_not_of(" \t\r\n");
+			args[i] = line.substr(starts[i], end + 1 - starts[i]);
+			args.resize(i + 1);
+			return true;
+		}
+		case CommandArg::Type::String:
+			break;
+		}
+		if (!valid) {
+			static const char *kTypeNames[] = {"text", "an integer", "a number",
+											   "true or false", "text"};
+			error = "'" + spec.name + "' must be " +
+					kTypeNames[static_cast<int>(spec.type)] + ", got '" +
+					value + "'";
+			return false;
+		}
+	}
+	if (args.size() > schema.size()) {
+		error = "Too many arguments";
+		return false;
+	}
+	return true;
+}
+
+// CommandRunner
+
+CommandRunner::CommandRunner(std::function<void()> onOutput)
+	: m_onOutput(std::move(onOutput)) {
+	// Started last so the worker only sees constructed members
+	m_worker = std::thread([this]() { workerLoop(); });
+}
+
+CommandRunner::~CommandRunner() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+		m_jobs.clear();
+		m_generation++;
+	}
+	m_wake.notify_all();
+	m_drained.notify_all();
+	// A handler that never checks isCancelled() holds this up until it ends
+	m_worker.join();
+}
+
+void CommandRunner::run(const Command &command, std::vector<std::string> args) {
+	Job job;
+	job.handler = command.handler;
+	job.context.m_name = command.name;
+	job.context.m_args = std::move(args);
+	job.context.m_runner = this;
+	if (command.execution == Command::Execution::UiThread) {
+		job.generation = job.context.m_generation = m_generation.load();
+		execute(job);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		job.generation = job.context.m_generation = m_generation.load();
+		m_jobs.push_back(std::move(job));
+	}
+	m_wake.notify_one();
+}
+
+void CommandRunner::cancel() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.clear();
+		m_generation++;
+	}
+	m_drained.notify_all();
+}
+
+bool CommandRunner::isBusy() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return !m_current.empty() || !m_jobs.empty();
+}
+
+std::string CommandRunner::getCurrentCommand() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_current;
+}
+
+size_t CommandRunner::takeOutput(std::vector<Output> &out) {
+	size_t count = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		count = m_output.size();
+		if (out.empty()) {
+			out.swap(m_output);
+		} else {
+			std::move(m_output.begin(), m_output.end(),
+					  std::back_inserter(out));
+			m_output.clear();
+		}
+	}
+	if (count > 0)
+		m_drained.notify_all();
+	return count;
+}
+
+void CommandRunner::push(uint64_t generation, std::string text, bool error) {
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		// A worker that outruns the UI waits for a drain instead of growing
+		// the queue; the UI thread itself never waits on itself
+		if (std::this_thread::get_id() == m_worker.get_id()) {
+			m_drained.wait(lock, [&]() {
+				return m_output.size() < kMaxPendingOutput ||
+					   m_generation.load() != generation;
+			});
+		}
+		if (m_generation.load() != generation)
+			return;
+		m_output.push_back({std::move(text), error});
+	}
+	if (m_onOutput)
+		m_onOutput();
+}
+
+void CommandRunner::execute(Job &job) {
+	try {
+		job.handler(job.context);
+	} catch (const std::exception &e) {
+		push(job.generation, job.context.m_name + ": " + e.what(), true);
+	} catch (...) {
+		push(job.generation, job.context.m_name + ": failed", true);
+	}
+}
+
+void CommandRunner::workerLoop() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_wake.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+		if (m_stop)
+			return;
+		Job job = std::move(m_jobs.front());
+		m_jobs.pop_front();
+		m_current = job.context.m_name;
+		lock.unlock();
+		execute(job);
+		lock.lock();
+		m_current.clear();
+		if (m_onOutput) {
+			// Let the UI notice the command finished
+			lock.unlock();
+			m_onOutput();
+			lock.lock();
+		}
+	}
+}
+
+} // namespace blot
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace blot {
+
+// Prefix tree over a set of strings. complete() lists the words under a
+// prefix in lexicographic order without scanning the whole set.
+class PrefixTrie {
+  public:
+	void insert(const std::string &word);
+	bool erase(const std::string &word);
+	bool contains(const std::string &word) const;
+	size_t size() const { return m_size; }
+	void clear();
+
+	// Appends up to maxResults words starting with prefix
+	size_t complete(const std::string &prefix, std::vector<std::string> &out,
+					size_t maxResults = SIZE_MAX) const;
+	// prefix extended by every character all words under it share
+	std::string commonPrefix(const std::string &prefix) const;
+
+  private:
+	struct Node {
+		std::vector<std::pair<char, uint32_t>> children; // sorted by char
+		uint32_t words = 0; // words at or below this node
+		bool terminal = false;
+	};
+
+	int findNode(const std::string &prefix) const;
+	void collect(uint32_t node, std::string &word,
+				 std::vector<std::string> &out, size_t maxResults) const;
+
+	std::vector<Node> m_nodes{Node()};
+	size_t m_size = 0;
+};
+
+// Typed positional argument of a command
+struct CommandArg {
+	enum class Type { String, Int, Float, Bool, Rest };
+	std::string name;
+	Type type = Type::String;
+	bool optional = false; // optional args must follow required ones
+	std::string description;
+};
+
+class CommandRunner;
+
+// What a handler sees: its validated arguments and an output stream into
+// the terminal. print() may be called from the handler's thread.
+class CommandContext {
+  public:
+	const std::string &name() const { return m_name; }
+	size_t argCount() const { return m_args.size(); }
+	bool has(size_t index) const { return index < m_args.size(); }
+	const std::string &arg(size_t index) const;
+	long long getInt(size_t index, long long fallback = 0) const;
+	double getFloat(size_t index, double fallback = 0.0) const;
+	bool getBool(size_t index, bool fallback = false) const;
+
+	void print(std::string line);
+	void error(std::string line);
+	// Long-running handlers should poll this and return early
+	bool isCancelled() const;
+
+  private:
+	friend class CommandRunner;
+	std::string m_name;
+	std::vector<std::string> m_args;
+	CommandRunner *m_runner = nullptr;
+	uint64_t m_generation = 0;
+};
+
+struct Command {
+	// Async handlers run on CommandRunner's worker; UiThread handlers run
+	// inline (for commands that touch windows, ImGui or the registry)
+	enum class Execution { Async, UiThread };
+
+	std::string name; // matched case-insensitively
+	std::vector<std::string> aliases;
+	std::string description;
+	std::vector<CommandArg> args;
+	Execution execution = Execution::Async;
+	std::function<void(CommandContext &)> handler;
+
+	// "name <required> [optional]"
+	std::string usage() const;
+};
+
+// Named commands with argument schemas. Registration and lookup are meant
+// for the UI thread; running handlers get copies.
+class CommandRegistry {
+  public:
+	// Fails on an empty or taken name, a missing handler or a malformed
+	// schema; error (if given) says why
+	bool add(Command command, std::string *error = nullptr);
+	bool remove(const std::string &name);
+	// By name or alias
+	const Command *find(const std::string &name) const;
+	// Sorted by name, aliases excluded
+	std::vector<const Command *> list() const;
+	// Names and aliases, for completion
+	const PrefixTrie &names() const { return m_names; }
+
+	// Splits on whitespace; double quotes group, and a backslash escapes a
+	// quote, space or backslash. starts (if given) receives each token's
+	// offset in line.
+	static std::vector<std::string>
+	tokenize(const std::string &line, std::vector<size_t> *starts = nullptr);
+	// Looks up the command in line and checks its arguments against the
+	// schema. A Rest argument receives the rest of the line verbatim.
+	// command is null when line names no command.
+	bool parse(const std::string &line, const Command *&command,
+			   std::vector<std::string> &args, std::string &error) const;
+
+  private:
+	std::unordered_map<std::string, Command> m_commands;
+	std::unordered_map<std::string, std::string> m_aliases; // alias -> name
+	PrefixTrie m_names;
+};
+
+// Runs Async commands one at a time on a worker thread. Output from any
+// command is queued and drained by the UI each frame, so long diagnostics
+// stream into the terminal while it keeps rendering.
+class CommandRunner {
+  public:
+	struct Output {
+		std::string text;
+		bool error = false;
+	};
+
+	// onOutput runs on the thread that produced output (to request a redraw)
+	explicit CommandRunner(std::function<void()> onOutput = {});
+	~CommandRunner();
+
+	CommandRunner(const CommandRunner &) = delete;
+	CommandRunner &operator=(const CommandRunner &) = delete;
+
+	// Queue an Async command, or run a UiThread one now
+	void run(const Command &command, std::vector<std::string> args);
+	// Cancels the running command and drops queued ones
+	void cancel();
+
+	bool isBusy() const;
+	std::string getCurrentCommand() const;
+	size_t takeOutput(std::vector<Output> &out);
+
+  private:
+	friend class CommandContext;
+	struct Job {
+		uint64_t generation = 0;
+		std::function<void(CommandContext &)> handler;
+		CommandContext context;
+	};
+
+	static constexpr size_t kMaxPendingOutput = 65536;
+
+	void workerLoop();
+	void execute(Job &job);
+	void push(uint64_t generation, std::string text, bool error);
+
+	std::thread m_worker;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_drained;
+	std::deque<Job> m_jobs;
+	std::vector<Output> m_output;
+	std::string m_current;
+	bool m_stop = false;
+	std::atomic<uint64_t> m_generation{0};
+	std::function<void()> m_onOutput;
+};
+
+} // namespace blot
@@ -1,6 +1,12 @@
 #include "DebugPanel.h"
+#include <algorithm>
 #include <imgui.h>
 #include <spdlog/spdlog.h>
+#include "AllocationCounter.h"
+#include "ImGuiAllocator.h"
+#ifdef BXIMGUI_HAS_IMPLOT
+#include <implot.h>
+#endif
 #include "ecs/MEcs.h"
 #include "ecs/components/CDrawStyle.h"
 #include "ecs/components/CShape.h"
@@ -16,15 +22,21 @@ void DebugPanel::renderContents() {
 	renderClearShapesButton();
 	renderEntityInfo();
 	renderPerformanceInfo();
+	renderAllocationInfo();
 }
 
 void DebugPanel::renderDebugInfo() {
+	float deltaTime =
+		m_deltaTime > 0.0f ? m_deltaTime : ImGui::GetIO().DeltaTime;
 	ImGui::Text("Debug Info:");
-	ImGui::Text("  Delta Time: %.3f ms", m_deltaTime * 1000.0f);
-	ImGui::Text("  Frame Rate: %.1f FPS", 1.0f / m_deltaTime);
+	ImGui::Text("  Delta Time: %.3f ms", deltaTime * 1000.0f);
+	ImGui::Text("  Frame Rate: %.1f FPS",
+				deltaTime > 0.0f ? 1.0f / deltaTime : 0.0f);
 }
 
 void DebugPanel::renderClearShapesButton() {
+	if (!m_ecs)
+		return;
 	if (ImGui::Button("Clear All Shapes")) {
 		spdlog::debug("[DebugPanel] === Before Clear ===");
 		spdlog::debug("[DebugPanel] Total entities: {}",
@@ -84,8 +96,136 @@ void DebugPanel::renderEntityInfo() {
 void DebugPanel::renderPerformanceInfo() {
 	ImGui::Separator();
 	ImGui::Text("Performance:");
-	ImGui::Text("  Memory Usage: TODO");
-	ImGui::Text("  GPU Memory: TODO");
+	if (!m_profiler) {
+		ImGui::Text("  Frame profiler not attached");
+		return;
+	}
+	renderFrameHistogram();
+	renderTimingTable();
+	renderTopOffenders();
+}
+
+void DebugPanel::renderFrameHistogram() {
+	auto frameTrack =
+		static_cast<FrameProfiler::TrackId>(FrameProfiler::Phase::Frame);
+	size_t count = m_profiler->copySamples(frameTrack, m_frameSamples.data(),
+										   m_frameSamples.size());
+	if (count == 0) {
+		ImGui::Text("  No frames recorded yet");
+		return;
+	}
+#ifdef BXIMGUI_HAS_IMPLOT
+	if (ImPlot::GetCurrentContext() &&
+		ImPlot::BeginPlot("Frame time histogram", ImVec2(-1, 160))) {
+		ImPlot::SetupAxes("ms", "frames", ImPlotAxisFlags_AutoFit,
+						  ImPlotAxisFlags_AutoFit);
+		ImPlot::PlotHistogram("Frame", m_frameSamples.data(),
+							  static_cast<int>(count), 32);
+		ImPlot::EndPlot();
+	}
+#else
+	ImGui::PlotHistogram("##FrameTimes", m_frameSamples.data(),
+						 static_cast<int>(count), 0, "Frame time (ms)", 0.0f,
+						 FLT_MAX, ImVec2(-1, 80));
+#endif
+}
+
+void DebugPanel::renderTimingTable() {
+	if (!ImGui::CollapsingHeader("CPU timings (ms)",
+								 ImGuiTreeNodeFlags_DefaultOpen))
+		return;
+	ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+							ImGuiTableFlags_SizingStretchProp;
+	if (!ImGui::BeginTable("##ProfilerTimings", 5, flags))
+		return;
+	ImGui::TableSetupColumn("Scope");
+	ImGui::TableSetupColumn("Last");
+	ImGui::TableSetupColumn("Mean");
+	ImGui::TableSetupColumn("p95");
+	ImGui::TableSetupColumn("p99");
+	ImGui::TableHeadersRow();
+	size_t trackCount = m_profiler->getTrackCount();
+	for (size_t i = 0; i < trackCount; i++) {
+		auto track = static_cast<FrameProfiler::TrackId>(i);
+		FrameProfiler::Stats stats = m_profiler->computeStats(track);
+		if (stats.samples == 0)
+			continue;
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		// Phases first, then one row per window
+		if (i < static_cast<size_t>(FrameProfiler::Phase::Count))
+			ImGui::TextUnformatted(m_profiler->getTrackName(track).c_str());
+		else
+			ImGui::BulletText("%s", m_profiler->getTrackName(track).c_str());
+		ImGui::TableNextColumn();
+		ImGui::Text("%.3f", stats.lastMs);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.3f", stats.meanMs);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.3f", stats.p95Ms);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.3f", stats.p99Ms);
+	}
+	ImGui::EndTable();
+}
+
+void DebugPanel::renderTopOffenders() {
+	static constexpr size_t kTopCount = 5;
+	m_offenders.clear();
+	size_t trackCount = m_profiler->getTrackCount();
+	for (size_t i = static_cast<size_t>(FrameProfiler::Phase::Count);
+		 i < trackCount; i++) {
+		auto track = static_cast<FrameProfiler::TrackId>(i);
+		FrameProfiler::Stats stats = m_profiler->computeStats(track);
+		if (stats.samples > 0)
+			m_offenders.emplace_back(stats.p95Ms, track);
+	}
+	size_t shown = (std::min)(kTopCount, m_offenders.size());
+	std::partial_sort(
+		m_offenders.begin(), m_offenders.begin() + shown, m_offenders.end(),
+		[](const auto &a, const auto &b) { return a.first > b.first; });
+
+	ImGui::Text("Top offenders (p95):");
+	for (size_t i = 0; i < shown; i++) {
+		ImGui::Text("  %zu. %s  %.3f ms", i + 1,
+					m_profiler->getTrackName(m_offenders[i].second).c_str(),
+					m_offenders[i].first);
+	}
+	if (shown == 0) {
+		ImGui::Text("  No window timings yet");
+	}
+}
+
+void DebugPanel::renderAllocationInfo() {
+	ImGui::Separator();
+	AllocationCounter::Counts frame = AllocationCounter::lastFrameCounts();
+	AllocationCounter::Counts total = AllocationCounter::globalCounts();
+	ImGui::Text("Allocations:");
+	ImGui::Text("  Last frame: %llu (%llu bytes)",
+				static_cast<unsigned long long>(frame.allocations),
+				static_cast<unsigned long long>(frame.bytes));
+	ImGui::Text("  Live: %llu",
+				static_cast<unsigned long long>(total.allocations -
+												total.frees));
+	if (!AllocationCounter::isOperatorNewHooked()) {
+		ImGui::TextDisabled("  operator new not counted "
+							"(BXIMGUI_COUNT_ALLOCATIONS=OFF)");
+	}
+
+	ImGuiAllocator &allocator = ImGuiAllocator::instance();
+	ImGuiAllocator::Stats stats = allocator.getStats();
+	bool pooled = allocator.getMode() == ImGuiAllocator::Mode::Pooled;
+	ImGui::Text("ImGui heap (%s):", pooled ? "pooled" : "malloc");
+	ImGui::Text("  Live: %.1f KB in %zu blocks", stats.liveBytes / 1024.0f,
+				stats.liveAllocations);
+	ImGui::Text("  Peak: %.1f KB", stats.peakBytes / 1024.0f);
+	ImGui::Text("  Reserved: %.1f KB (%zu slabs)",
+				stats.reservedBytes / 1024.0f, stats.slabCount);
+	ImGui::Text("  Fragmentation: %.1f%%", stats.fragmentation() * 100.0f);
+	if (ImGui::Checkbox("Pooled ImGui allocator", &pooled)) {
+		allocator.setMode(pooled ? ImGuiAllocator::Mode::Pooled
+								 : ImGuiAllocator::Mode::Malloc);
+	}
 }
 
 } // namespace blot
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <array>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace blot {
 class MEcs;
 }
 #include <imgui.h>
+#include "FrameProfiler.h"
 #include "Window.h"
 
 namespace blot {
@@ -19,18 +23,30 @@ class DebugPanel : public Window {
 	// Debug functionality
 	void setECSManager(MEcs *ecs) { m_ecs = ecs; }
 	void setDeltaTime(float deltaTime) { m_deltaTime = deltaTime; }
+	void setFrameProfiler(const FrameProfiler *profiler) {
+		m_profiler = profiler;
+	}
 
 	void renderContents() override;
 
   private:
 	MEcs *m_ecs = nullptr;
 	float m_deltaTime = 0.0f;
+	const FrameProfiler *m_profiler = nullptr;
+
+	// Scratch buffers reused every frame
+	std::array<float, FrameProfiler::kHistory> m_frameSamples{};
+	std::vector<std::pair<float, FrameProfiler::TrackId>> m_offenders;
 
 	// Debug methods
 	void renderDebugInfo();
 	void renderClearShapesButton();
 	void renderEntityInfo();
 	void renderPerformanceInfo();
+	void renderFrameHistogram();
+	void renderTimingTable();
+	void renderTopOffenders();
+	void renderAllocationInfo();
 };
 
 } // namespace blot
@@ -0,0 +1,413 @@
+#include "FontAtlasCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <imgui.h>
+#include <spdlog/spdlog.h>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "MappedFile.h"
+
+// ImGui 1.92 bakes glyphs on demand and replaced the atlas internals this
+// cache restores; there (a newer third_party/imgui checkout, the fetched
+// one is pinned below 1.92) the atlas is simply built
+#define BXIMGUI_FONT_ATLAS_CACHE (IMGUI_VERSION_NUM < 19200)
+
+namespace blot {
+
+namespace {
+
+constexpr char kCacheMagic[4] = {'B', 'X', 'F', 'A'};
+constexpr uint32_t kCacheVersion = 1;
+constexpr const char *kCacheExtension = ".bxfont";
+// Older files (other fonts, sizes or scales) beyond this are removed
+constexpr size_t kMaxCacheFiles = 8;
+constexpr uint32_t kTexLineCount = IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1;
+
+// File layout: header, line UVs, one FontRecord per font, every font's
+// glyphs in font order, the atlas' custom rects, then alpha8 pixels
+struct CacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t key;
+	uint32_t imguiVersion;
+	int32_t texWidth;
+	int32_t texHeight;
+	uint32_t fontCount;
+	uint32_t rectCount;
+	int32_t packIdMouseCursors;
+	int32_t packIdLines;
+	uint32_t lineUvCount;
+	float uvScale[2];
+	float uvWhitePixel[2];
+};
+static_assert(sizeof(CacheHeader) == 64, "font cache header layout");
+
+struct FontRecord {
+	float fontSize;
+	float ascent;
+	float descent;
+	uint32_t fallbackChar;
+	uint32_t ellipsisChar;
+	uint32_t glyphCount;
+};
+
+struct GlyphRecord {
+	uint32_t codepoint;
+	float advanceX;
+	float x0, y0, x1, y1;
+	float u0, v0, u1, v1;
+};
+
+struct RectRecord {
+	uint16_t width;
+	uint16_t height;
+	uint16_t x;
+	uint16_t y;
+};
+
+class KeyHash {
+  public:
+	void add(const void *data, size_t size) {
+		const unsigned char *bytes = static_cast<const unsigned char *>(data);
+		for (size_t i = 0; i < size; i++) {
+			m_hash ^= bytes[i];
+			m_hash *= 1099511628211ull;
+		}
+	}
+	template <typename T> void addValue(const T &value) {
+		add(&value, sizeof(value));
+	}
+	uint64_t get() const { return m_hash; }
+
+  private:
+	uint64_t m_hash = 14695981039346656037ull;
+};
+
+template <typename T> T readRecord(const char *data, size_t offset) {
+	T record;
+	std::memcpy(&record, data + offset, sizeof(T));
+	return record;
+}
+
+} // namespace
+
+#if BXIMGUI_FONT_ATLAS_CACHE
+
+uint64_t FontAtlasCache::computeKey(const ImFontAtlas *atlas, float uiScale) {
+	KeyHash hash;
+	hash.addValue(kCacheVersion);
+	hash.addValue(static_cast<int32_t>(IMGUI_VERSION_NUM));
+	hash.addValue(static_cast<uint32_t>(sizeof(ImWchar)));
+#ifdef IMGUI_ENABLE_FREETYPE
+	hash.addValue(uint8_t(1));
+#endif
+	hash.addValue(uiScale);
+	hash.addValue(atlas->Flags);
+	hash.addValue(atlas->TexDesiredWidth);
+	hash.addValue(atlas->TexGlyphPadding);
+	for (const ImFontConfig &config : atlas->ConfigData) {
+		hash.addValue(config.FontDataSize);
+		hash.add(config.FontData, static_cast<size_t>(config.FontDataSize));
+		hash.addValue(config.FontNo);
+		hash.addValue(config.SizePixels);
+		hash.addValue(config.OversampleH);
+		hash.addValue(config.OversampleV);
+		hash.addValue(config.PixelSnapH);
+		hash.addValue(config.GlyphOffset.x);
+		hash.addValue(config.GlyphOffset.y);
+		hash.addValue(config.GlyphMinAdvanceX);
+		hash.addValue(config.GlyphMaxAdvanceX);
+		hash.addValue(config.MergeMode);
+		hash.addValue(config.FontBuilderFlags);
+		hash.addValue(config.RasterizerMultiply);
+		hash.addValue(config.EllipsisChar);
+		// No ranges means ImGui's default (Basic Latin + Latin-1),
+		// which the version above already pins
+		for (const ImWchar *range = config.GlyphRanges; range && range[0];
+			 range += 2)
+			hash.add(range, 2 * sizeof(ImWchar));
+		hash.addValue(ImWchar(0));
+	}
+	return hash.get();
+}
+
+#else
+
+uint64_t FontAtlasCache::computeKey(const ImFontAtlas *, float) { return 0; }
+
+#endif
+
+bool FontAtlasCache::build(ImFontAtlas *atlas, float uiScale) {
+	const auto start = std::chrono::steady_clock::now();
+	m_lastCached = false;
+	if (atlas->IsBuilt())
+		return true;
+
+#if BXIMGUI_FONT_ATLAS_CACHE
+	// Rects added by the caller get their pixels written after the build,
+	// so such an atlas cannot be restored from a file
+	const bool cacheable = !m_directory.empty() && !atlas->Fonts.empty() &&
+						   atlas->CustomRects.empty();
+	uint64_t key = 0;
+	std::string path;
+	if (cacheable) {
+		key = computeKey(atlas, uiScale);
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx%s",
+				 static_cast<unsigned long long>(key), kCacheExtension);
+		path = (std::filesystem::path(m_directory) / name).string();
+		m_lastCached = load(atlas, key, path);
+	}
+#else
+	(void)uiScale;
+#endif
+	if (!m_lastCached) {
+		if (!atlas->Build()) {
+			spdlog::error("[FontAtlasCache] Failed to build the font atlas");
+			return false;
+		}
+#if BXIMGUI_FONT_ATLAS_CACHE
+		if (cacheable)
+			save(atlas, key, path);
+#endif
+	}
+
+	m_lastBuildMs = std::chrono::duration<double, std::milli>(
+						std::chrono::steady_clock::now() - start)
+						.count();
+	spdlog::info("[FontAtlasCache] {} {}x{} font atlas in {:.1f} ms",
+				 m_lastCached ? "Restored" : "Built", atlas->TexWidth,
+				 atlas->TexHeight, m_lastBuildMs);
+	return true;
+}
+
+#if BXIMGUI_FONT_ATLAS_CACHE
+
+bool FontAtlasCache::load(ImFontAtlas *atlas, uint64_t key,
+						  const std::string &path) {
+	// Missing on first launch and after any change to the key
+	std::shared_ptr<MappedFile> file = MappedFile::open(path);
+	if (!file)
+		return false;
+	const char *data = file->data();
+	const size_t size = file->size();
+
+	// Validate the whole layout before the atlas is touched
+	auto stale = [&path](const char *reason) {
+		spdlog::warn("[FontAtlasCache] Ignoring {}: {}", path, reason);
+		return false;
+	};
+	if (size < sizeof(CacheHeader))
+		return stale("truncated");
+	const CacheHeader header = readRecord<CacheHeader>(data, 0);
+	if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+		header.version != kCacheVersion || header.key != key ||
+		header.imguiVersion != IMGUI_VERSION_NUM)
+		return stale("different format or key");
+	if (header.fontCount != static_cast<uint32_t>(atlas->Fonts.Size) ||
+		header.lineUvCount != kTexLineCount || header.texWidth <= 0 ||
+		header.texHeight <= 0)
+		return stale("does not match the atlas");
+	if (header.packIdMouseCursors >= static_cast<int32_t>(header.rectCount) ||
+		header.packIdLines >= static_cast<int32_t>(header.rectCount))
+		return stale("bad rect ids");
+
+	size_t offset = sizeof(CacheHeader);
+	const size_t linesOffset = offset;
+	offset += sizeof(ImVec4) * header.lineUvCount;
+	const size_t fontsOffset = offset;
+	offset += sizeof(FontRecord) * header.fontCount;
+	if (offset > size)
+		return stale("truncated");
+	uint64_t glyphCount = 0;
+	for (uint32_t i = 0; i < header.fontCount; i++)
+		glyphCount += readRecord<FontRecord>(
+						  data, fontsOffset + i * sizeof(FontRecord))
+						  .glyphCount;
+	const size_t pixelCount =
+		static_cast<size_t>(header.texWidth) * header.texHeight;
+	const size_t glyphsOffset = offset;
+	offset += sizeof(GlyphRecord) * glyphCount;
+	const size_t rectsOffset = offset;
+	offset += sizeof(RectRecord) * header.rectCount;
+	const size_t pixelsOffset = offset;
+	offset += pixelCount;
+	if (offset != size)
+		return stale("wrong size");
+
+	atlas->ClearTexData();
+	atlas->TexWidth = header.texWidth;
+	atlas->TexHeight = header.texHeight;
+	atlas->TexUvScale = ImVec2(header.uvScale[0], header.uvScale[1]);
+	atlas->TexUvWhitePixel =
+		ImVec2(header.uvWhitePixel[0], header.uvWhitePixel[1]);
+	std::memcpy(atlas->TexUvLines, data + linesOffset,
+				sizeof(ImVec4) * kTexLineCount);
+	// The atlas frees its pixels itself, so they get their own copy
+	atlas->TexPixelsAlpha8 = static_cast<unsigned char *>(IM_ALLOC(pixelCount));
+	std::memcpy(atlas->TexPixelsAlpha8, data + pixelsOffset, pixelCount);
+
+	for (uint32_t i = 0; i < header.rectCount; i++) {
+		const RectRecord record =
+			readRecord<RectRecord>(data, rectsOffset + i * sizeof(RectRecord));
+		ImFontAtlasCustomRect rect;
+		rect.Width = record.width;
+		rect.Height = record.height;
+		rect.X = record.x;
+		rect.Y = record.y;
+		atlas->CustomRects.push_back(rect);
+	}
+	atlas->PackIdMouseCursors = header.packIdMouseCursors;
+	atlas->PackIdLines = header.packIdLines;
+
+	size_t glyphOffset = glyphsOffset;
+	for (int i = 0; i < atlas->Fonts.Size; i++) {
+		ImFont *font = atlas->Fonts[i];
+		const FontRecord record =
+			readRecord<FontRecord>(data, fontsOffset + i * sizeof(FontRecord));
+		// What the builder's font setup does, with the cached metrics
+		font->ClearOutputData();
+		font->ContainerAtlas = atlas;
+		font->FontSize = record.fontSize;
+		font->Ascent = record.ascent;
+		font->Descent = record.descent;
+		for (uint32_t g = 0; g < record.glyphCount; g++) {
+			const GlyphRecord glyph = readRecord<GlyphRecord>(data, glyphOffset);
+			glyphOffset += sizeof(GlyphRecord);
+			// No config: offsets, snapping and min advance are baked in
+			font->AddGlyph(nullptr, static_cast<ImWchar>(glyph.codepoint),
+						   glyph.x0, glyph.y0, glyph.x1, glyph.y1, glyph.u0,
+						   glyph.v0, glyph.u1, glyph.v1, glyph.advanceX);
+		}
+		font->FallbackChar = static_cast<ImWchar>(record.fallbackChar);
+		font->EllipsisChar = static_cast<ImWchar>(record.ellipsisChar);
+		font->BuildLookupTable();
+	}
+	atlas->TexReady = true;
+
+	// Keeps recently used files clear of pruning
+	std::error_code ec;
+	std::filesystem::last_write_time(
+		path, std::filesystem::file_time_type::clock::now(), ec);
+	return true;
+}
+
+bool FontAtlasCache::save(ImFontAtlas *atlas, uint64_t key,
+						  const std::string &path) {
+	// Colored glyphs only exist in the RGBA texture; left uncached
+	if (!atlas->TexPixelsAlpha8 || atlas->TexPixelsUseColors)
+		return false;
+
+	CacheHeader header = {};
+	std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+	header.version = kCacheVersion;
+	header.key = key;
+	header.imguiVersion = IMGUI_VERSION_NUM;
+	header.texWidth = atlas->TexWidth;
+	header.texHeight = atlas->TexHeight;
+	header.fontCount = static_cast<uint32_t>(atlas->Fonts.Size);
+	header.rectCount = static_cast<uint32_t>(atlas->CustomRects.Size);
+	header.packIdMouseCursors = atlas->PackIdMouseCursors;
+	header.packIdLines = atlas->PackIdLines;
+	header.lineUvCount = kTexLineCount;
+	header.uvScale[0] = atlas->TexUvScale.x;
+	header.uvScale[1] = atlas->TexUvScale.y;
+	header.uvWhitePixel[0] = atlas->TexUvWhitePixel.x;
+	header.uvWhitePixel[1] = atlas->TexUvWhitePixel.y;
+
+	std::vector<FontRecord> fonts;
+	std::vector<GlyphRecord> glyphs;
+	for (const ImFont *font : atlas->Fonts) {
+		fonts.push_back({font->FontSize, font->Ascent, font->Descent,
+						 static_cast<uint32_t>(font->FallbackChar),
+						 static_cast<uint32_t>(font->EllipsisChar),
+						 static_cast<uint32_t>(font->Glyphs.Size)});
+		for (const ImFontGlyph &glyph : font->Glyphs)
+			glyphs.push_back({static_cast<uint32_t>(glyph.Codepoint),
+							  glyph.AdvanceX, glyph.X0, glyph.Y0, glyph.X1,
+							  glyph.Y1, glyph.U0, glyph.V0, glyph.U1,
+							  glyph.V1});
+	}
+	std::vector<RectRecord> rects;
+	for (const ImFontAtlasCustomRect &rect : atlas->CustomRects) {
+		if (rect.Font)
+			return false; // custom glyphs belong to the caller
+		rects.push_back({static_cast<uint16_t>(rect.Width),
+						 static_cast<uint16_t>(rect.Height),
+						 static_cast<uint16_t>(rect.X),
+						 static_cast<uint16_t>(rect.Y)});
+	}
+
+	std::error_code ec;
+	std::filesystem::create_directories(m_directory, ec);
+	// Written aside and renamed, so a reader never maps a partial file
+	const std::string tempPath = path + ".tmp";
+	std::FILE *file = std::fopen(tempPath.c_str(), "wb");
+	if (!file) {
+		spdlog::warn("[FontAtlasCache] Cannot write {}", tempPath);
+		return false;
+	}
+	const size_t pixelCount =
+		static_cast<size_t>(atlas->TexWidth) * atlas->TexHeight;
+	bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+	ok = ok && std::fwrite(atlas->TexUvLines, sizeof(ImVec4), kTexLineCount,
+						   file) == kTexLineCount;
+	ok = ok && std::fwrite(fonts.data(), sizeof(FontRecord), fonts.size(),
+						   file) == fonts.size();
+	ok = ok && std::fwrite(glyphs.data(), sizeof(GlyphRecord), glyphs.size(),
+						   file) == glyphs.size();
+	ok = ok && std::fwrite(rects.data(), sizeof(RectRecord), rects.size(),
+						   file) == rects.size();
+	ok = ok && std::fwrite(atlas->TexPixelsAlpha8, 1, pixelCount, file) ==
+				   pixelCount;
+	ok = (std::fclose(file) == 0) && ok;
+	if (ok)
+		std::filesystem::rename(tempPath, path, ec);
+	if (!ok || ec) {
+		spdlog::warn("[FontAtlasCache] Cannot write {}", path);
+		std::filesystem::remove(tempPath, ec);
+		return false;
+	}
+	prune(path);
+	return true;
+}
+
+void FontAtlasCache::prune(const std::string &keep) {
+	namespace fs = std::filesystem;
+	std::error_code ec;
+	std::vector<std::pair<fs::file_time_type, fs::path>> files;
+	for (fs::directory_iterator it(m_directory, ec), end; !ec && it != end;
+		 it.increment(ec)) {
+		std::error_code timeError;
+		if (it->path().extension() == kCacheExtension &&
+			it->path() != fs::path(keep))
+			files.emplace_back(it->last_write_time(timeError), it->path());
+	}
+	if (files.size() < kMaxCacheFiles)
+		return;
+	// Newest first; the file just written counts toward the limit
+	std::sort(files.begin(), files.end(),
+			  [](const auto &a, const auto &b) { return a.first > b.first; });
+	for (size_t i = kMaxCacheFiles - 1; i < files.size(); i++)
+		fs::remove(files[i].second, ec);
+}
+
+#else
+
+bool FontAtlasCache::load(ImFontAtlas *, uint64_t, const std::string &) {
+	return false;
+}
+
+bool FontAtlasCache::save(ImFontAtlas *, uint64_t, const std::string &) {
+	return false;
+}
+
+void FontAtlasCache::prune(const std::string &) {}
+
+#endif
+
+} // namespace blot
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+struct ImFontAtlas;
+
+namespace blot {
+
+// Disk cache for the baked ImGui font atlas. A cache file holds the alpha8
+// pixels, every font's glyph table and metrics, and the atlas' own rects
+// and UVs (white pixel, lines, mouse cursors). It is keyed by a hash of the
+// font bytes, sizes, glyph ranges, config flags, UI scale and ImGui version,
+// so any change there simply misses. A hit maps the file and restores the
+// atlas without running the rasterizer. ImGui's atlas has no kerning table;
+// glyph advances are all it keeps, and all the cache needs.
+class FontAtlasCache {
+  public:
+	explicit FontAtlasCache(std::string directory = "")
+		: m_directory(std::move(directory)) {}
+
+	// Empty disables the cache: build() then just builds the atlas
+	void setDirectory(const std::string &directory) { m_directory = directory; }
+	const std::string &getDirectory() const { return m_directory; }
+
+	// Call once the fonts are added and before anything builds the atlas.
+	// Restores a matching cache file when there is one, otherwise builds the
+	// atlas and writes the file. False only when the atlas could not be
+	// built; cache problems are logged and fall back to a normal build.
+	bool build(ImFontAtlas *atlas, float uiScale);
+
+	bool wasLastBuildCached() const { return m_lastCached; }
+	double getLastBuildMs() const { return m_lastBuildMs; }
+
+	static uint64_t computeKey(const ImFontAtlas *atlas, float uiScale);
+
+  private:
+	bool load(ImFontAtlas *atlas, uint64_t key, const std::string &path);
+	bool save(ImFontAtlas *atlas, uint64_t key, const std::string &path);
+	void prune(const std::string &keep);
+
+	std::string m_directory;
+	bool m_lastCached = false;
+	double m_lastBuildMs = 0.0;
+};
+
+} // namespace blot
@@ -0,0 +1,99 @@
+#include "FrameProfiler.h"
+#include <algorithm>
+
+namespace blot {
+
+FrameProfiler::FrameProfiler() {
+	for (int i = 0; i < static_cast<int>(Phase::Count); i++) {
+		registerTrack(getPhaseName(static_cast<Phase>(i)));
+	}
+}
+
+const char *FrameProfiler::getPhaseName(Phase phase) {
+	switch (phase) {
+	case Phase::Frame:
+		return "Frame";
+	case Phase::NewFrame:
+		return "NewFrame";
+	case Phase::Dockspace:
+		return "Dockspace";
+	case Phase::MenuBar:
+		return "MenuBar";
+	case Phase::Windows:
+		return "Windows";
+	case Phase::Notifications:
+		return "Toasts/Modals";
+	case Phase::ImGuiRender:
+		return "ImGui::Render";
+	case Phase::RenderDrawData:
+		return "RenderDrawData";
+	default:
+		return "Unknown";
+	}
+}
+
+FrameProfiler::TrackId FrameProfiler::registerTrack(const std::string &name) {
+	size_t count = m_trackCount.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < count; i++) {
+		if (m_tracks[i].name == name)
+			return static_cast<TrackId>(i);
+	}
+	if (count >= kMaxTracks)
+		return kInvalidTrack;
+	m_tracks[count].name = name;
+	m_trackCount.store(count + 1, std::memory_order_release);
+	return static_cast<TrackId>(count);
+}
+
+void FrameProfiler::record(TrackId track, int64_t nanoseconds) {
+	if (track < 0 || static_cast<size_t>(track) >= getTrackCount())
+		return;
+	Track &t = m_tracks[track];
+	uint64_t head = t.head.load(std::memory_order_relaxed);
+	t.samples[head % kHistory].store(nanoseconds, std::memory_order_relaxed);
+	t.head.store(head + 1, std::memory_order_release);
+}
+
+size_t FrameProfiler::copySamples(TrackId track, float *outMs,
+								  size_t maxSamples) const {
+	if (track < 0 || static_cast<size_t>(track) >= getTrackCount())
+		return 0;
+	const Track &t = m_tracks[track];
+	uint64_t head = t.head.load(std::memory_order_acquire);
+	size_t count = static_cast<size_t>(std::min<uint64_t>(head, kHistory));
+	count = std::min(count, maxSamples);
+	for (size_t i = 0; i < count; i++) {
+		uint64_t index = (head - count + i) % kHistory;
+		outMs[i] = static_cast<float>(
+			t.samples[index].load(std::memory_order_relaxed) / 1.0e6);
+	}
+	return count;
+}
+
+FrameProfiler::Stats FrameProfiler::computeStats(TrackId track) const {
+	Stats stats;
+	std::array<float, kHistory> samples;
+	size_t count = copySamples(track, samples.data(), samples.size());
+	if (count == 0)
+		return stats;
+
+	stats.samples = count;
+	stats.lastMs = samples[count - 1];
+	float sum = 0.0f;
+	for (size_t i = 0; i < count; i++)
+		sum += samples[i];
+	stats.meanMs = sum / static_cast<float>(count);
+
+	auto percentile = [&](float p) {
+		size_t k = static_cast<size_t>(p * static_cast<float>(count - 1));
+		std::nth_element(samples.begin(), samples.begin() + k,
+						 samples.begin() + count);
+		return samples[k];
+	};
+	stats.p95Ms = percentile(0.95f);
+	stats.p99Ms = percentile(0.99f);
+	stats.maxMs = *std::max_element(samples.begin(), samples.begin() + count);
+	return stats;
+}
+
+} // namespace blot
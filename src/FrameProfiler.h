@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace blot {
+
+// CPU timings for the UI frame. Every track (a frame phase or a window) owns
+// a fixed-size ring of its most recent samples. The single writer per track
+// publishes each sample with a release store of the ring head, so readers
+// (DebugPanel, other threads) snapshot the rings without taking locks.
+class FrameProfiler {
+  public:
+	using TrackId = int;
+	static constexpr TrackId kInvalidTrack = -1;
+	static constexpr size_t kMaxTracks = 256;
+	static constexpr size_t kHistory = 256; // samples kept per track
+
+	// Phases of Mui::update(), registered as the first tracks
+	enum class Phase {
+		Frame,
+		NewFrame,
+		Dockspace,
+		MenuBar,
+		Windows,
+		Notifications,
+		ImGuiRender,
+		RenderDrawData,
+		Count
+	};
+
+	struct Stats {
+		float lastMs = 0.0f;
+		float meanMs = 0.0f;
+		float p95Ms = 0.0f;
+		float p99Ms = 0.0f;
+		float maxMs = 0.0f;
+		size_t samples = 0;
+	};
+
+	// Times a scope into a track; a no-op for null profilers or tracks
+	class Scope {
+	  public:
+		Scope(FrameProfiler *profiler, TrackId track)
+			: m_profiler(profiler), m_track(track) {
+			if (m_profiler && m_profiler->isEnabled() &&
+				m_track != kInvalidTrack) {
+				m_start = std::chrono::steady_clock::now();
+			} else {
+				m_profiler = nullptr;
+			}
+		}
+		Scope(FrameProfiler *profiler, Phase phase)
+			: Scope(profiler, static_cast<TrackId>(phase)) {}
+		~Scope() {
+			if (m_profiler) {
+				auto elapsed = std::chrono::steady_clock::now() - m_start;
+				m_profiler->record(
+					m_track,
+					std::chrono::duration_cast<std::chrono::nanoseconds>(
+						elapsed)
+						.count());
+			}
+		}
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+	  private:
+		FrameProfiler *m_profiler;
+		TrackId m_track;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	FrameProfiler();
+
+	// Returns the existing track with this name, or a new one.
+	// kInvalidTrack once kMaxTracks are in use. Call from the UI thread.
+	TrackId registerTrack(const std::string &name);
+	void record(TrackId track, int64_t nanoseconds);
+
+	void setEnabled(bool enabled) { m_enabled = enabled; }
+	bool isEnabled() const { return m_enabled; }
+
+	size_t getTrackCount() const {
+		return m_trackCount.load(std::memory_order_acquire);
+	}
+	const std::string &getTrackName(TrackId track) const {
+		return m_tracks[track].name;
+	}
+	static const char *getPhaseName(Phase phase);
+
+	// Copies up to maxSamples samples (oldest first) in milliseconds
+	size_t copySamples(TrackId track, float *outMs, size_t maxSamples) const;
+	Stats computeStats(TrackId track) const;
+
+  private:
+	struct Track {
+		std::string name;
+		std::atomic<uint64_t> head{0};
+		std::array<std::atomic<int64_t>, kHistory> samples{};
+	};
+
+	std::array<Track, kMaxTracks> m_tracks;
+	std::atomic<size_t> m_trackCount{0};
+	bool m_enabled = true;
+};
+
+} // namespace blot
@@ -0,0 +1,567 @@
+#include "GlyphLoader.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <imgui.h>
+#include <imgui_impl_opengl3.h>
+#include <imgui_internal.h>
+#include <spdlog/spdlog.h>
+#include "rendering/U_gladGlfw.h"
+
+// ImGui 1.92 loads glyphs on demand itself; there the loader only merges
+// the added sources into the atlas fonts
+#define BXIMGUI_GLYPH_LOADER (IMGUI_VERSION_NUM < 19200)
+
+#if BXIMGUI_GLYPH_LOADER
+// A private copy: imgui_draw.cpp compiles its own as static
+#define STB_TRUETYPE_IMPLEMENTATION
+#define STBTT_STATIC
+#include <imstb_truetype.h>
+#endif
+
+namespace blot {
+
+#if BXIMGUI_GLYPH_LOADER
+
+namespace {
+
+// Texture growth step and ceiling, in rows
+constexpr int kGrowRows = 256;
+constexpr int kMaxTexHeight = 4096;
+// Codepoints waiting on the worker; more are asked for again later
+constexpr size_t kMaxPending = 4096;
+
+} // namespace
+
+struct GlyphLoader::Source {
+	std::vector<unsigned char> data;
+	stbtt_fontinfo info;
+	float sizePixels = 0.0f; // 0: the size of the font it fills in for
+	float offsetX = 0.0f;
+	float offsetY = 0.0f;
+	float minAdvanceX = 0.0f;
+	float maxAdvanceX = FLT_MAX;
+	bool pixelSnapH = false;
+};
+
+std::shared_ptr<GlyphLoader::Source>
+GlyphLoader::makeSource(std::vector<unsigned char> data, int fontNo) {
+	auto source = std::make_shared<Source>();
+	source->data = std::move(data);
+	const int offset =
+		stbtt_GetFontOffsetForIndex(source->data.data(), fontNo);
+	if (offset < 0 ||
+		!stbtt_InitFont(&source->info, source->data.data(), offset))
+		return nullptr;
+	return source;
+}
+
+#endif
+
+GlyphLoader *GlyphLoader::s_active = nullptr;
+
+GlyphLoader::GlyphLoader() {
+	s_active = this;
+#if BXIMGUI_GLYPH_LOADER
+	m_worker = std::thread([this]() { workerLoop(); });
+#endif
+}
+
+GlyphLoader::~GlyphLoader() {
+	if (s_active == this)
+		s_active = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_one();
+	if (m_worker.joinable())
+		m_worker.join();
+}
+
+bool GlyphLoader::addSource(const std::string &path) {
+	std::FILE *file = std::fopen(path.c_str(), "rb");
+	if (!file) {
+		spdlog::warn("[GlyphLoader] Cannot open font {}", path);
+		return false;
+	}
+	std::vector<unsigned char> data;
+	unsigned char buffer[65536];
+	size_t read = 0;
+	while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+		data.insert(data.end(), buffer, buffer + read);
+	std::fclose(file);
+	addSource(std::move(data));
+	return true;
+}
+
+void GlyphLoader::addSource(std::vector<unsigned char> data) {
+#if BXIMGUI_GLYPH_LOADER
+	auto source = makeSource(std::move(data), 0);
+	if (!source) {
+		spdlog::warn("[GlyphLoader] Not a TrueType font");
+		return;
+	}
+	m_extraSources.push_back(std::move(source));
+	// Rebuilt with the new source; codepoints nothing had get another try
+	m_fontSources.clear();
+	m_requested.clear();
+#else
+	// Merged into the fonts by the next update(), outside any frame
+	m_mergeSources.push_back(std::move(data));
+#endif
+}
+
+void GlyphLoader::request(const char *text, const char *textEnd) {
+#if BXIMGUI_GLYPH_LOADER
+	if (!text || !ImGui::GetCurrentContext())
+		return;
+	ImFontAtlas *atlas = ImGui::GetIO().Fonts;
+	if (!atlas->IsBuilt())
+		return;
+	const char *p = text;
+	while (textEnd ? p < textEnd : *p != '\0') {
+		if (static_cast<unsigned char>(*p) < 0x80) {
+			p++;
+			continue;
+		}
+		unsigned int codepoint = 0;
+		p += ImTextCharFromUtf8(&codepoint, p, textEnd);
+		requestCodepoint(atlas, codepoint);
+	}
+#else
+	(void)text;
+	(void)textEnd;
+#endif
+}
+
+void GlyphLoader::collectFrameInput() {
+#if BXIMGUI_GLYPH_LOADER
+	ImGuiIO &io = ImGui::GetIO();
+	if (!io.Fonts->IsBuilt())
+		return;
+	for (ImWchar c : io.InputQueueCharacters)
+		requestCodepoint(io.Fonts, c);
+	// Pasted text lands in a field this frame; the clipboard says what
+	const bool paste =
+		((io.KeyCtrl || io.KeySuper) && ImGui::IsKeyPressed(ImGuiKey_V, false)) ||
+		(io.KeyShift && ImGui::IsKeyPressed(ImGuiKey_Insert, false));
+	if (paste)
+		request(ImGui::GetClipboardText());
+#endif
+}
+
+void GlyphLoader::requestCodepoint(ImFontAtlas *atlas, uint32_t codepoint) {
+#if BXIMGUI_GLYPH_LOADER
+	if (codepoint < 0x80 || codepoint > IM_UNICODE_CODEPOINT_MAX ||
+		codepoint == IM_UNICODE_CODEPOINT_INVALID ||
+		(codepoint >= 0xD800 && codepoint <= 0xDFFF))
+		return;
+	for (int i = 0; i < atlas->Fonts.Size; i++) {
+		ImFont *font = atlas->Fonts[i];
+		if (font->FindGlyphNoFallback(static_cast<ImWchar>(codepoint)))
+			continue;
+		const uint64_t key = (static_cast<uint64_t>(i) << 32) | codepoint;
+		if (m_pending >= kMaxPending || !m_requested.insert(key).second)
+			continue;
+		Job job;
+		job.generation = m_generation;
+		job.font = i;
+		job.codepoint = codepoint;
+		job.fontSize = font->FontSize;
+		job.ascent = font->Ascent;
+		job.sources = sourcesFor(atlas, i);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back(std::move(job));
+		}
+		m_wake.notify_one();
+		m_pending++;
+	}
+#else
+	(void)atlas;
+	(void)codepoint;
+#endif
+}
+
+std::shared_ptr<const GlyphLoader::SourceList>
+GlyphLoader::sourcesFor(ImFontAtlas *atlas, int font) {
+#if BXIMGUI_GLYPH_LOADER
+	if (m_fontSources.size() <= static_cast<size_t>(font))
+		m_fontSources.resize(font + 1);
+	if (m_fontSources[font])
+		return m_fontSources[font];
+	// The font's own files first, with the sizes and offsets it was baked
+	// with; copied, since the atlas may drop them on its next Clear()
+	auto sources = std::make_shared<SourceList>();
+	for (const ImFontConfig &config : atlas->ConfigData) {
+		if (config.DstFont != atlas->Fonts[font] || !config.FontData)
+			continue;
+		const unsigned char *bytes =
+			static_cast<const unsigned char *>(config.FontData);
+		auto source = makeSource(
+			std::vector<unsigned char>(bytes, bytes + config.FontDataSize),
+			config.FontNo);
+		if (!source)
+			continue;
+		source->sizePixels = config.SizePixels;
+		source->offsetX = config.GlyphOffset.x;
+		source->offsetY = config.GlyphOffset.y;
+		source->minAdvanceX = config.GlyphMinAdvanceX;
+		source->maxAdvanceX = config.GlyphMaxAdvanceX;
+		source->pixelSnapH = config.PixelSnapH;
+		sources->push_back(std::move(source));
+	}
+	sources->insert(sources->end(), m_extraSources.begin(),
+					m_extraSources.end());
+	m_fontSources[font] = sources;
+	return sources;
+#else
+	(void)atlas;
+	(void)font;
+	return nullptr;
+#endif
+}
+
+void GlyphLoader::workerLoop() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_wake.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+		if (m_stop)
+			return;
+		Job job = std::move(m_jobs.front());
+		m_jobs.pop_front();
+		lock.unlock();
+		Result result;
+		result.generation = job.generation;
+		result.font = job.font;
+		result.codepoint = job.codepoint;
+		rasterize(job, result);
+		lock.lock();
+		m_results.push_back(std::move(result));
+		// One wake-up per batch
+		if (m_jobs.empty() && m_readyCallback) {
+			lock.unlock();
+			m_readyCallback();
+			lock.lock();
+		}
+	}
+}
+
+void GlyphLoader::rasterize(const Job &job, Result &result) {
+#if BXIMGUI_GLYPH_LOADER
+	for (const auto &source : *job.sources) {
+		const int glyph =
+			stbtt_FindGlyphIndex(&source->info, static_cast<int>(job.codepoint));
+		if (glyph == 0)
+			continue;
+		const float size =
+			source->sizePixels > 0.0f ? source->sizePixels : job.fontSize;
+		const float scale = stbtt_ScaleForPixelHeight(&source->info, size);
+		int advance = 0, leftBearing = 0;
+		stbtt_GetGlyphHMetrics(&source->info, glyph, &advance, &leftBearing);
+		int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+		stbtt_GetGlyphBitmapBox(&source->info, glyph, scale, scale, &x0, &y0,
+								&x1, &y1);
+		result.width = x1 - x0;
+		result.height = y1 - y0;
+		if (result.width > 0 && result.height > 0) {
+			result.pixels.resize(static_cast<size_t>(result.width) *
+								 result.height);
+			stbtt_MakeGlyphBitmap(&source->info, result.pixels.data(),
+								  result.width, result.height, result.width,
+								  scale, scale, glyph);
+		}
+		// Placed and spaced the way ImGui's builder does it
+		float advanceX = advance * scale;
+		result.x0 = x0 + source->offsetX;
+		result.y0 = y0 + source->offsetY + std::floor(job.ascent + 0.5f);
+		const float clamped = (std::min)(
+			(std::max)(advanceX, source->minAdvanceX), source->maxAdvanceX);
+		if (clamped != advanceX) {
+			const float shift = (clamped - advanceX) * 0.5f;
+			result.x0 += source->pixelSnapH ? std::floor(shift) : shift;
+			advanceX = clamped;
+		}
+		if (source->pixelSnapH)
+			advanceX = std::floor(advanceX + 0.5f);
+		result.advanceX = advanceX;
+		result.found = true;
+		return;
+	}
+#else
+	(void)job;
+	(void)result;
+#endif
+}
+
+bool GlyphLoader::update() {
+#if BXIMGUI_GLYPH_LOADER
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_results.empty())
+			return false;
+		m_resultScratch.swap(m_results);
+	}
+	ImFontAtlas *atlas = ImGui::GetIO().Fonts;
+	std::vector<bool> dirtyFonts(atlas->Fonts.Size, false);
+	bool added = false;
+	for (const Result &result : m_resultScratch) {
+		if (result.generation != m_generation)
+			continue;
+		m_pending--;
+		if (!result.found || result.font >= atlas->Fonts.Size) {
+			m_unavailable++;
+			continue;
+		}
+		ImFont *font = atlas->Fonts[result.font];
+		const ImWchar codepoint = static_cast<ImWchar>(result.codepoint);
+		if (font->FindGlyphNoFallback(codepoint))
+			continue; // asked for twice around an addSource()
+		ImVec2 uv0(0.0f, 0.0f), uv1(0.0f, 0.0f);
+		if (result.width > 0 && result.height > 0) {
+			int x = 0, y = 0;
+			if (!place(atlas, result.width, result.height, x, y)) {
+				m_unavailable++;
+				continue;
+			}
+			const int stride = atlas->TexWidth;
+			for (int row = 0; row < result.height; row++) {
+				const unsigned char *src =
+					result.pixels.data() +
+					static_cast<size_t>(row) * result.width;
+				const size_t dst = static_cast<size_t>(y + row) * stride + x;
+				if (atlas->TexPixelsAlpha8)
+					std::memcpy(atlas->TexPixelsAlpha8 + dst, src,
+								result.width);
+				if (atlas->TexPixelsRGBA32) {
+					for (int col = 0; col < result.width; col++)
+						atlas->TexPixelsRGBA32[dst + col] =
+							IM_COL32(255, 255, 255, src[col]);
+				}
+			}
+			uv0 = ImVec2(x * atlas->TexUvScale.x, y * atlas->TexUvScale.y);
+			uv1 = ImVec2((x + result.width) * atlas->TexUvScale.x,
+						 (y + result.height) * atlas->TexUvScale.y);
+		}
+		font->AddGlyph(nullptr, codepoint, result.x0, result.y0,
+					   result.x0 + result.width, result.y0 + result.height,
+					   uv0.x, uv0.y, uv1.x, uv1.y, result.advanceX);
+		dirtyFonts[result.font] = true;
+		m_loaded++;
+		added = true;
+	}
+	m_resultScratch.clear();
+	for (int i = 0; i < atlas->Fonts.Size; i++) {
+		if (dirtyFonts[i])
+			atlas->Fonts[i]->BuildLookupTable();
+	}
+	uploadTexture(atlas);
+	return added;
+#else
+	return mergeSources();
+#endif
+}
+
+bool GlyphLoader::mergeSources() {
+#if BXIMGUI_GLYPH_LOADER
+	return false;
+#else
+	if (m_mergeSources.empty() || !ImGui::GetCurrentContext())
+		return false;
+	ImFontAtlas *atlas = ImGui::GetIO().Fonts;
+	bool merged = false;
+	for (ImFont *font : atlas->Fonts) {
+		auto it = std::find_if(
+			m_mergedFonts.begin(), m_mergedFonts.end(),
+			[font](const auto &entry) { return entry.first == font; });
+		if (it == m_mergedFonts.end()) {
+			m_mergedFonts.emplace_back(font, 0);
+			it = m_mergedFonts.end() - 1;
+		}
+		for (; it->second < m_mergeSources.size(); it->second++) {
+			const std::vector<unsigned char> &data =
+				m_mergeSources[it->second];
+			// The atlas frees its copy
+			void *copy = IM_ALLOC(data.size());
+			std::memcpy(copy, data.data(), data.size());
+			ImFontConfig config;
+			config.MergeMode = true;
+			config.DstFont = font;
+			config.FontDataOwnedByAtlas = true;
+			// No glyph ranges: anything the font lacks comes from here
+			if (!atlas->AddFontFromMemoryTTF(copy,
+											 static_cast<int>(data.size()),
+											 font->LegacySize, &config)) {
+				spdlog::warn("[GlyphLoader] Cannot merge font source {}",
+							 it->second);
+				continue;
+			}
+			merged = true;
+		}
+	}
+	return merged;
+#endif
+}
+
+void GlyphLoader::reset() {
+	m_generation++;
+	m_requested.clear();
+	m_fontSources.clear();
+	// A cleared atlas has new fonts; sources are merged into them again
+	m_mergedFonts.clear();
+	m_pending = 0;
+	m_atlasFull = false;
+	m_shelfX = 0;
+	m_shelfY = -1;
+	m_shelfHeight = 0;
+	m_dirtyBegin = 0;
+	m_dirtyEnd = 0;
+	m_textureResized = false;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_jobs.clear();
+	m_results.clear();
+}
+
+bool GlyphLoader::place(ImFontAtlas *atlas, int width, int height, int &x,
+						int &y) {
+#if BXIMGUI_GLYPH_LOADER
+	const int padding = (std::max)(atlas->TexGlyphPadding, 1);
+	if (m_atlasFull || width + padding > atlas->TexWidth ||
+		(!atlas->TexPixelsAlpha8 && !atlas->TexPixelsRGBA32))
+		return false;
+	if (m_shelfY < 0) {
+		// Below everything baked, which packs up to TexHeight
+		m_shelfY = atlas->TexHeight + padding;
+		m_shelfX = padding;
+		m_shelfHeight = 0;
+	}
+	if (m_shelfX + width + padding > atlas->TexWidth) {
+		m_shelfY += m_shelfHeight;
+		m_shelfX = padding;
+		m_shelfHeight = 0;
+	}
+	if (m_shelfY + height + padding > atlas->TexHeight &&
+		!growAtlas(atlas, m_shelfY + height + padding))
+		return false;
+	x = m_shelfX;
+	y = m_shelfY;
+	m_shelfX += width + padding;
+	m_shelfHeight = (std::max)(m_shelfHeight, height + padding);
+	if (m_dirtyEnd == 0) {
+		m_dirtyBegin = y;
+		m_dirtyEnd = y + height;
+	} else {
+		m_dirtyBegin = (std::min)(m_dirtyBegin, y);
+		m_dirtyEnd = (std::max)(m_dirtyEnd, y + height);
+	}
+	return true;
+#else
+	(void)atlas;
+	(void)width;
+	(void)height;
+	(void)x;
+	(void)y;
+	return false;
+#endif
+}
+
+bool GlyphLoader::growAtlas(ImFontAtlas *atlas, int height) {
+#if BXIMGUI_GLYPH_LOADER
+	const int oldHeight = atlas->TexHeight;
+	int newHeight = oldHeight;
+	while (newHeight < height)
+		newHeight += kGrowRows;
+	if (newHeight > kMaxTexHeight) {
+		spdlog::warn("[GlyphLoader] Font atlas is full at {} rows; further "
+					 "glyphs show as placeholders",
+					 oldHeight);
+		m_atlasFull = true;
+		return false;
+	}
+	const size_t oldCount = static_cast<size_t>(atlas->TexWidth) * oldHeight;
+	const size_t newCount = static_cast<size_t>(atlas->TexWidth) * newHeight;
+	if (atlas->TexPixelsAlpha8) {
+		auto *pixels = static_cast<unsigned char *>(IM_ALLOC(newCount));
+		std::memcpy(pixels, atlas->TexPixelsAlpha8, oldCount);
+		std::memset(pixels + oldCount, 0, newCount - oldCount);
+		IM_FREE(atlas->TexPixelsAlpha8);
+		atlas->TexPixelsAlpha8 = pixels;
+	}
+	if (atlas->TexPixelsRGBA32) {
+		auto *pixels = static_cast<unsigned int *>(
+			IM_ALLOC(newCount * sizeof(unsigned int)));
+		std::memcpy(pixels, atlas->TexPixelsRGBA32,
+					oldCount * sizeof(unsigned int));
+		std::fill(pixels + oldCount, pixels + newCount,
+				  IM_COL32(255, 255, 255, 0));
+		IM_FREE(atlas->TexPixelsRGBA32);
+		atlas->TexPixelsRGBA32 = pixels;
+	}
+	// Rows keep their place; only the V coordinates shrink
+	const float ratio = static_cast<float>(oldHeight) / newHeight;
+	for (ImFont *font : atlas->Fonts) {
+		for (ImFontGlyph &glyph : font->Glyphs) {
+			glyph.V0 *= ratio;
+			glyph.V1 *= ratio;
+		}
+	}
+	atlas->TexUvWhitePixel.y *= ratio;
+	for (ImVec4 &uv : atlas->TexUvLines) {
+		uv.y *= ratio;
+		uv.w *= ratio;
+	}
+	atlas->TexHeight = newHeight;
+	atlas->TexUvScale.y = 1.0f / newHeight;
+	m_textureResized = true;
+	return true;
+#else
+	(void)atlas;
+	(void)height;
+	return false;
+#endif
+}
+
+void GlyphLoader::uploadTexture(ImFontAtlas *atlas) {
+#if BXIMGUI_GLYPH_LOADER
+	if (!m_textureResized && m_dirtyEnd == 0)
+		return;
+	ImGuiIO &io = ImGui::GetIO();
+	const bool openGL = io.BackendRendererName &&
+						std::strcmp(io.BackendRendererName,
+									"imgui_impl_opengl3") == 0;
+	if (openGL) {
+		if (m_textureResized || !atlas->TexPixelsRGBA32) {
+			ImGui_ImplOpenGL3_DestroyFontsTexture();
+			ImGui_ImplOpenGL3_CreateFontsTexture();
+		} else {
+			// Same size: only the rows the new glyphs touched
+			GLint lastTexture = 0;
+			glGetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+			glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)atlas->TexID);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_dirtyBegin, atlas->TexWidth,
+							m_dirtyEnd - m_dirtyBegin, GL_RGBA,
+							GL_UNSIGNED_BYTE,
+							atlas->TexPixelsRGBA32 +
+								static_cast<size_t>(m_dirtyBegin) *
+									atlas->TexWidth);
+			glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(lastTexture));
+		}
+	}
+	m_textureResized = false;
+	m_dirtyBegin = 0;
+	m_dirtyEnd = 0;
+#else
+	(void)atlas;
+#endif
+}
+
+void requestGlyphs(const char *text, const char *textEnd) {
+	if (GlyphLoader *loader = GlyphLoader::getActive())
+		loader->request(text, textEnd);
+}
+
+} // namespace blot
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+struct ImFont;
+struct ImFontAtlas;
+
+namespace blot {
+
+// Loads glyphs the atlas was not baked with, on demand. Text handed to
+// request() is checked against the atlas fonts; codepoints they lack are
+// rasterized on a worker thread, from the fonts the atlas was built from
+// (they usually hold far more than the baked ranges) and then from any
+// added sources, e.g. a CJK font. update() packs finished glyphs into a
+// region below the baked ones, growing the texture by whole pages, and
+// uploads only the rows that changed. Until its glyph lands a codepoint
+// draws as the font's fallback glyph. A codepoint no source has is never
+// asked for again. Everything but the worker runs on the UI thread.
+//
+// ImGui 1.92 and later bake glyphs on demand themselves. There the loader
+// only merges the added sources into every atlas font, without glyph
+// ranges, so ImGui rasterizes what the fonts lack from them.
+class GlyphLoader {
+  public:
+	GlyphLoader();
+	~GlyphLoader();
+
+	GlyphLoader(const GlyphLoader &) = delete;
+	GlyphLoader &operator=(const GlyphLoader &) = delete;
+
+	// Fonts searched, in order, after the atlas' own
+	bool addSource(const std::string &path);
+	void addSource(std::vector<unsigned char> data);
+
+	// Called on the worker thread when glyphs are ready for update(); set
+	// it before the first request()
+	void setReadyCallback(std::function<void()> callback) {
+		m_readyCallback = std::move(callback);
+	}
+
+	// Queues the codepoints of text the atlas fonts lack
+	void request(const char *text, const char *textEnd = nullptr);
+	// After ImGui::NewFrame(): requests typed characters and pasted text
+	void collectFrameInput();
+	// Before ImGui::NewFrame(): adds finished glyphs to the atlas. Returns
+	// true when any were added.
+	bool update();
+	// The atlas was cleared and rebuilt: drops everything in flight
+	void reset();
+
+	size_t getLoadedCount() const { return m_loaded; }
+	size_t getUnavailableCount() const { return m_unavailable; }
+	size_t getPendingCount() const { return m_pending; }
+
+	// The loader request() calls go to from outside ImGuiRenderer
+	static GlyphLoader *getActive() { return s_active; }
+
+  private:
+	struct Source;
+	using SourceList = std::vector<std::shared_ptr<const Source>>;
+	struct Job {
+		uint64_t generation = 0;
+		int font = 0;
+		uint32_t codepoint = 0;
+		float fontSize = 0.0f;
+		float ascent = 0.0f;
+		std::shared_ptr<const SourceList> sources;
+	};
+	struct Result {
+		uint64_t generation = 0;
+		int font = 0;
+		uint32_t codepoint = 0;
+		bool found = false;
+		int width = 0;
+		int height = 0;
+		float x0 = 0.0f;
+		float y0 = 0.0f;
+		float advanceX = 0.0f;
+		std::vector<unsigned char> pixels;
+	};
+
+	static std::shared_ptr<Source> makeSource(std::vector<unsigned char> data,
+											  int fontNo);
+	void requestCodepoint(ImFontAtlas *atlas, uint32_t codepoint);
+	std::shared_ptr<const SourceList> sourcesFor(ImFontAtlas *atlas,
+												 int font);
+	void workerLoop();
+	static void rasterize(const Job &job, Result &result);
+
+	bool place(ImFontAtlas *atlas, int width, int height, int &x, int &y);
+	bool growAtlas(ImFontAtlas *atlas, int height);
+	void uploadTexture(ImFontAtlas *atlas);
+	bool mergeSources();
+
+	static GlyphLoader *s_active;
+
+	// UI thread state
+	uint64_t m_generation = 0;
+	std::unordered_set<uint64_t> m_requested; // font << 32 | codepoint
+	std::vector<std::shared_ptr<const SourceList>> m_fontSources;
+	SourceList m_extraSources;
+	// ImGui 1.92+: added font files, and how many of them each atlas font
+	// has merged
+	std::vector<std::vector<unsigned char>> m_mergeSources;
+	std::vector<std::pair<const ImFont *, size_t>> m_mergedFonts;
+	std::vector<Result> m_resultScratch;
+	size_t m_loaded = 0;
+	size_t m_unavailable = 0;
+	size_t m_pending = 0;
+	bool m_atlasFull = false;
+	// Shelf packing below the baked glyphs; dirty rows await upload
+	int m_shelfX = 0;
+	int m_shelfY = -1; // -1 until the first glyph is placed
+	int m_shelfHeight = 0;
+	int m_dirtyBegin = 0;
+	int m_dirtyEnd = 0;
+	bool m_textureResized = false;
+
+	// Shared with the worker
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::deque<Job> m_jobs;
+	std::vector<Result> m_results;
+	bool m_stop = false;
+	std::function<void()> m_readyCallback;
+	std::thread m_worker;
+};
+
+// Forwards to the active GlyphLoader, if any; UI thread only
+void requestGlyphs(const char *text, const char *textEnd = nullptr);
+
+} // namespace blot
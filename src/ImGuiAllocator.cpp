@@ -0,0 +1,131 @@
+#include "ImGuiAllocator.h"
+#include <cstdlib>
+#include <imgui.h>
+#include "AllocationCounter.h"
+
+namespace blot {
+
+namespace {
+// Sits in front of every block handed to ImGui; 16 bytes keeps the payload
+// aligned like malloc's
+struct BlockHeader {
+	uint32_t sizeClass;
+	uint32_t reserved;
+	uint64_t size;
+};
+static_assert(sizeof(BlockHeader) == 16, "header must preserve alignment");
+} // namespace
+
+ImGuiAllocator &ImGuiAllocator::instance() {
+	static ImGuiAllocator *allocator = new ImGuiAllocator();
+	return *allocator;
+}
+
+void ImGuiAllocator::install() {
+	ImGui::SetAllocatorFunctions(&ImGuiAllocator::allocate,
+								 &ImGuiAllocator::release, this);
+}
+
+void ImGuiAllocator::setMode(Mode mode) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_mode = mode;
+}
+
+ImGuiAllocator::Mode ImGuiAllocator::getMode() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_mode;
+}
+
+ImGuiAllocator::Stats ImGuiAllocator::getStats() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+void *ImGuiAllocator::allocate(size_t size, void *userData) {
+	AllocationCounter::recordAllocation(size);
+	return static_cast<ImGuiAllocator *>(userData)->allocateBlock(size);
+}
+
+void ImGuiAllocator::release(void *ptr, void *userData) {
+	if (!ptr)
+		return;
+	AllocationCounter::recordFree();
+	static_cast<ImGuiAllocator *>(userData)->releaseBlock(ptr);
+}
+
+int ImGuiAllocator::classFor(size_t blockSize) {
+	size_t classSize = kMinBlock;
+	for (size_t i = 0; i < kClassCount; i++, classSize <<= 1) {
+		if (blockSize <= classSize)
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+bool ImGuiAllocator::refill(Pool &pool) {
+	auto *slab = static_cast<char *>(std::malloc(kSlabSize));
+	if (!slab)
+		return false;
+	m_slabs.push_back(slab);
+	m_stats.slabCount++;
+	m_stats.reservedBytes += kSlabSize;
+	// Thread the new blocks onto the free list in address order
+	size_t blocks = kSlabSize / pool.blockSize;
+	for (size_t i = blocks; i-- > 0;) {
+		auto *block = reinterpret_cast<FreeBlock *>(slab + i * pool.blockSize);
+		block->next = pool.freeList;
+		pool.freeList = block;
+	}
+	return true;
+}
+
+void *ImGuiAllocator::allocateBlock(size_t size) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t blockSize = size + kHeaderSize;
+	int sizeClass = m_mode == Mode::Pooled ? classFor(blockSize) : -1;
+
+	BlockHeader *header = nullptr;
+	if (sizeClass >= 0) {
+		Pool &pool = m_pools[sizeClass];
+		if (pool.blockSize == 0)
+			pool.blockSize = kMinBlock << sizeClass;
+		if (!pool.freeList && !refill(pool))
+			return nullptr;
+		header = reinterpret_cast<BlockHeader *>(pool.freeList);
+		pool.freeList = pool.freeList->next;
+		header->sizeClass = static_cast<uint32_t>(sizeClass);
+	} else {
+		header = static_cast<BlockHeader *>(std::malloc(blockSize));
+		if (!header)
+			return nullptr;
+		header->sizeClass = kMallocClass;
+		m_stats.reservedBytes += blockSize;
+	}
+	header->size = size;
+
+	m_stats.liveBytes += size;
+	m_stats.liveAllocations++;
+	if (m_stats.liveBytes > m_stats.peakBytes)
+		m_stats.peakBytes = m_stats.liveBytes;
+	return reinterpret_cast<char *>(header) + kHeaderSize;
+}
+
+void ImGuiAllocator::releaseBlock(void *ptr) {
+	auto *header = reinterpret_cast<BlockHeader *>(static_cast<char *>(ptr) -
+												   kHeaderSize);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stats.liveBytes -= static_cast<size_t>(header->size);
+	m_stats.liveAllocations--;
+	if (header->sizeClass == kMallocClass) {
+		m_stats.reservedBytes -=
+			static_cast<size_t>(header->size) + kHeaderSize;
+		std::free(header);
+		return;
+	}
+	auto *block = reinterpret_cast<FreeBlock *>(header);
+	Pool &pool = m_pools[header->sizeClass];
+	block->next = pool.freeList;
+	pool.freeList = block;
+}
+
+} // namespace blot
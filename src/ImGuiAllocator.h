@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace blot {
+
+// Allocator installed for Dear ImGui through ImGui::SetAllocatorFunctions().
+// Small requests are served from per-size-class pools carved out of fixed
+// slabs; slab memory is recycled through free lists and never returned, so
+// ImGui's constant vector growth/shrink stops churning the general heap.
+// Requests above the largest class go to malloc. Every block carries a
+// header naming its origin, which makes switching modes at runtime safe.
+class ImGuiAllocator {
+  public:
+	enum class Mode { Pooled, Malloc };
+
+#ifdef BXIMGUI_IMGUI_MALLOC
+	static constexpr Mode kDefaultMode = Mode::Malloc;
+#else
+	static constexpr Mode kDefaultMode = Mode::Pooled;
+#endif
+
+	struct Stats {
+		size_t liveBytes = 0;	  // bytes requested by ImGui and not freed
+		size_t peakBytes = 0;	  // high-water mark of liveBytes
+		size_t reservedBytes = 0; // slabs + outstanding malloc blocks
+		size_t liveAllocations = 0;
+		size_t slabCount = 0;
+		// Share of reserved memory not holding live data (0..1)
+		float fragmentation() const {
+			return reservedBytes > 0
+					   ? 1.0f - static_cast<float>(liveBytes) /
+									static_cast<float>(reservedBytes)
+					   : 0.0f;
+		}
+	};
+
+	// Process-wide instance; intentionally never destroyed because ImGui
+	// buffers (e.g. window snapshots) may be released after Mui is gone
+	static ImGuiAllocator &instance();
+
+	// Register with ImGui; must happen before ImGui::CreateContext()
+	void install();
+
+	void setMode(Mode mode);
+	Mode getMode() const;
+	Stats getStats() const;
+
+	// ImGui::SetAllocatorFunctions() callbacks; userData is the allocator
+	static void *allocate(size_t size, void *userData);
+	static void release(void *ptr, void *userData);
+
+  private:
+	ImGuiAllocator() = default;
+
+	static constexpr size_t kHeaderSize = 16;
+	static constexpr size_t kMinBlock = 32;
+	static constexpr size_t kClassCount = 8; // 32 .. 4096 byte blocks
+	static constexpr size_t kSlabSize = 64 * 1024;
+	static constexpr uint32_t kMallocClass = 0xFFFFFFFFu;
+
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	struct Pool {
+		FreeBlock *freeList = nullptr;
+		size_t blockSize = 0;
+	};
+
+	void *allocateBlock(size_t size);
+	void releaseBlock(void *ptr);
+	bool refill(Pool &pool);
+	static int classFor(size_t blockSize);
+
+	mutable std::mutex m_mutex;
+	Mode m_mode = kDefaultMode;
+	std::array<Pool, kClassCount> m_pools{};
+	std::vector<void *> m_slabs;
+	Stats m_stats;
+};
+
+} // namespace blot
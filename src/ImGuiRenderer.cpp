@@ -1,5 +1,6 @@
 #include "ImGuiRenderer.h"
 #include <iostream>
+#include "FontAtlasCache.h"
 #include "imgui_impl_opengl3.h"
 
 ImGuiRenderer::ImGuiRenderer()
@@ -45,6 +46,10 @@ void ImGuiRenderer::setCustomFont(const std::string &fontPath, int fontSize) {
 		// Fall back to default font
 		m_customImGuiFont = io.Fonts->AddFontDefault();
 	}
+	if (m_fontCache)
+		m_fontCache->build(io.Fonts, 1.0f);
+	// Glyphs loaded into the old atlas went with it
+	m_glyphLoader.reset();
 
 	m_useCustomFont = true;
 }
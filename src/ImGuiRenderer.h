@@ -3,6 +3,11 @@
 #include <memory>
 #include <string>
 #include <imgui.h>
+#include "GlyphLoader.h"
+
+namespace blot {
+class FontAtlasCache;
+}
 
 class ImGuiRenderer {
   public:
@@ -12,6 +17,17 @@ class ImGuiRenderer {
 	void init();
 	void render();
 	void setCustomFont(const std::string &fontPath, int fontSize = 16);
+	// setCustomFont() bakes the rebuilt atlas through this cache when set
+	void setFontCache(blot::FontAtlasCache *cache) { m_fontCache = cache; }
+
+	// Glyphs the atlas lacks, loaded as text asks for them. Call
+	// updateGlyphs() before ImGui::NewFrame() and collectFrameText() after.
+	blot::GlyphLoader &getGlyphLoader() { return m_glyphLoader; }
+	bool updateGlyphs() { return m_glyphLoader.update(); }
+	void collectFrameText() { m_glyphLoader.collectFrameInput(); }
+	void requestGlyphs(const char *text, const char *textEnd = nullptr) {
+		m_glyphLoader.request(text, textEnd);
+	}
 
 	// ImGui integration helpers
 	void pushCustomFont();
@@ -25,4 +41,6 @@ class ImGuiRenderer {
 	// ImGui font atlas
 	ImFont *m_customImGuiFont;
 	ImFontAtlas *m_fontAtlas;
+	blot::FontAtlasCache *m_fontCache = nullptr;
+	blot::GlyphLoader m_glyphLoader;
 };
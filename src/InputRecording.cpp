@@ -0,0 +1,372 @@
+#include "InputRecording.h"
+#include <algorithm>
+#include <cstring>
+#include <imgui.h>
+#include <imgui_internal.h>
+
+namespace blot {
+
+static constexpr char kMagic[4] = {'B', 'X', 'I', 'R'};
+static constexpr uint32_t kVersion = 1;
+static constexpr size_t kFlushSize = 64 * 1024;
+
+// Own event codes, so streams do not depend on ImGui's enum values
+enum RecordedEventType : uint8_t {
+	EventMousePos = 1,
+	EventMouseWheel = 2,
+	EventMouseButton = 3,
+	EventKey = 4,
+	EventText = 5,
+	EventFocus = 6,
+};
+
+struct FileHeader {
+	char magic[4];
+	uint32_t version;
+};
+
+struct FrameHeader {
+	float deltaTime;
+	float displayWidth;
+	float displayHeight;
+	uint32_t eventCount;
+};
+
+struct EventRecord {
+	uint8_t type;
+	uint8_t source;
+	uint8_t down;
+	uint8_t reserved;
+	int32_t code;
+	float x;
+	float y;
+};
+static_assert(sizeof(EventRecord) == 16, "EventRecord must stay packed");
+
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t size) {
+	const unsigned char *bytes = static_cast<const unsigned char *>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static constexpr uint64_t kFnvBasis = 1469598103934665603ull;
+
+template <typename T>
+static void append(std::vector<uint8_t> &out, const T &value) {
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+	out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// InputRecorder
+
+InputRecorder::~InputRecorder() { close(); }
+
+bool InputRecorder::open(const std::string &path) {
+	close();
+	m_error.clear();
+	m_file = std::fopen(path.c_str(), "wb");
+	if (!m_file) {
+		m_error = "Cannot open " + path + " for writing";
+		return false;
+	}
+	FileHeader header;
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kVersion;
+	m_buffer.clear();
+	append(m_buffer, header);
+	m_frames = 0;
+	// Events queued before recording started are not part of the stream
+	m_lastEventId = ImGui::GetCurrentContext()
+						? ImGui::GetCurrentContext()->InputEventsNextEventId - 1
+						: 0;
+	return true;
+}
+
+void InputRecorder::close() {
+	if (!m_file)
+		return;
+	flush();
+	std::fclose(m_file);
+	m_file = nullptr;
+}
+
+void InputRecorder::flush() {
+	if (!m_file || m_buffer.empty())
+		return;
+	if (std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) !=
+		m_buffer.size()) {
+		m_error = "Write failed; recording stopped";
+		std::fclose(m_file);
+		m_file = nullptr;
+	}
+	m_buffer.clear();
+}
+
+void InputRecorder::recordFrame(ImGuiContext &context) {
+	if (!m_file)
+		return;
+	const ImGuiIO &io = context.IO;
+	const size_t headerOffset = m_buffer.size();
+	FrameHeader header = {io.DeltaTime, io.DisplaySize.x, io.DisplaySize.y, 0};
+	append(m_buffer, header);
+
+	for (const ImGuiInputEvent &event : context.InputEventsQueue) {
+		if (event.EventId <= m_lastEventId)
+			continue;
+		m_lastEventId = event.EventId;
+		EventRecord record = {};
+		switch (event.Type) {
+		case ImGuiInputEventType_MousePos:
+			record.type = EventMousePos;
+			record.source = static_cast<uint8_t>(event.MousePos.MouseSource);
+			record.x = event.MousePos.PosX;
+			record.y = event.MousePos.PosY;
+			break;
+		case ImGuiInputEventType_MouseWheel:
+			record.type = EventMouseWheel;
+			record.source = static_cast<uint8_t>(event.MouseWheel.MouseSource);
+			record.x = event.MouseWheel.WheelX;
+			record.y = event.MouseWheel.WheelY;
+			break;
+		case ImGuiInputEventType_MouseButton:
+			record.type = EventMouseButton;
+			record.source = static_cast<uint8_t>(event.MouseButton.MouseSource);
+			record.code = event.MouseButton.Button;
+			record.down = event.MouseButton.Down ? 1 : 0;
+			break;
+		case ImGuiInputEventType_Key:
+			record.type = EventKey;
+			record.code = static_cast<int32_t>(event.Key.Key);
+			record.down = event.Key.Down ? 1 : 0;
+			record.x = event.Key.AnalogValue;
+			break;
+		case ImGuiInputEventType_Text:
+			record.type = EventText;
+			record.code = static_cast<int32_t>(event.Text.Char);
+			break;
+		case ImGuiInputEventType_Focus:
+			record.type = EventFocus;
+			record.down = event.AppFocused.Focused ? 1 : 0;
+			break;
+		default:
+			// Viewport hover ids are meaningless in another session
+			continue;
+		}
+		append(m_buffer, record);
+		header.eventCount++;
+	}
+	std::memcpy(m_buffer.data() + headerOffset, &header, sizeof(header));
+	m_frames++;
+	if (m_buffer.size() >= kFlushSize)
+		flush();
+}
+
+// InputReplayReport
+
+double InputReplayReport::getTotalMs() const {
+	double total = 0.0;
+	for (const Frame &frame : frames)
+		total += frame.cpuMs;
+	return total;
+}
+
+double InputReplayReport::getMeanMs() const {
+	return frames.empty() ? 0.0 : getTotalMs() / double(frames.size());
+}
+
+double InputReplayReport::getPercentileMs(double percentile) const {
+	if (frames.empty())
+		return 0.0;
+	std::vector<double> times;
+	times.reserve(frames.size());
+	for (const Frame &frame : frames)
+		times.push_back(frame.cpuMs);
+	const double clamped = (std::min)((std::max)(percentile, 0.0), 100.0);
+	const size_t index = static_cast<size_t>(
+		clamped / 100.0 * static_cast<double>(times.size() - 1) + 0.5);
+	std::nth_element(times.begin(), times.begin() + index, times.end());
+	return times[index];
+}
+
+double InputReplayReport::getMaxMs() const {
+	double result = 0.0;
+	for (const Frame &frame : frames)
+		result = (std::max)(result, frame.cpuMs);
+	return result;
+}
+
+bool InputReplayReport::writeCsv(const std::string &path) const {
+	std::FILE *file = std::fopen(path.c_str(), "w");
+	if (!file)
+		return false;
+	std::fprintf(file, "frame,cpu_ms,draw_lists,draw_commands,vertices,"
+					   "indices,draw_hash\n");
+	for (size_t i = 0; i < frames.size(); i++) {
+		const Frame &frame = frames[i];
+		std::fprintf(file, "%zu,%.4f,%u,%u,%u,%u,%016llx\n", i, frame.cpuMs,
+					 frame.drawLists, frame.drawCommands, frame.vertices,
+					 frame.indices,
+					 static_cast<unsigned long long>(frame.drawHash));
+	}
+	std::fprintf(file,
+				 "# frames=%zu mean_ms=%.4f p50_ms=%.4f p95_ms=%.4f "
+				 "p99_ms=%.4f max_ms=%.4f combined_hash=%016llx\n",
+				 frames.size(), getMeanMs(), getPercentileMs(50.0),
+				 getPercentileMs(95.0), getPercentileMs(99.0), getMaxMs(),
+				 static_cast<unsigned long long>(combinedHash));
+	return std::fclose(file) == 0;
+}
+
+// InputReplayer
+
+bool InputReplayer::load(const std::string &path) {
+	m_frames.clear();
+	m_events.clear();
+	m_next = 0;
+	m_report = InputReplayReport();
+	m_error.clear();
+
+	std::FILE *file = std::fopen(path.c_str(), "rb");
+	if (!file) {
+		m_error = "Cannot open " + path;
+		return false;
+	}
+	std::vector<uint8_t> data;
+	uint8_t chunk[64 * 1024];
+	size_t count = 0;
+	while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+		data.insert(data.end(), chunk, chunk + count);
+	std::fclose(file);
+
+	FileHeader header;
+	if (data.size() < sizeof(header)) {
+		m_error = path + " is not an input recording";
+		return false;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+	if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+		header.version != kVersion) {
+		m_error = path + " is not an input recording (or a newer version)";
+		return false;
+	}
+
+	size_t offset = sizeof(header);
+	while (offset + sizeof(FrameHeader) <= data.size()) {
+		FrameHeader frameHeader;
+		std::memcpy(&frameHeader, data.data() + offset, sizeof(frameHeader));
+		offset += sizeof(frameHeader);
+		const size_t eventBytes =
+			size_t(frameHeader.eventCount) * sizeof(EventRecord);
+		if (eventBytes > data.size() - offset)
+			break; // truncated by a crash mid-write: keep what is complete
+		Frame frame;
+		frame.deltaTime = frameHeader.deltaTime;
+		frame.displayWidth = frameHeader.displayWidth;
+		frame.displayHeight = frameHeader.displayHeight;
+		frame.firstEvent = static_cast<uint32_t>(m_events.size());
+		frame.eventCount = frameHeader.eventCount;
+		for (uint32_t i = 0; i < frameHeader.eventCount; i++) {
+			EventRecord record;
+			std::memcpy(&record, data.data() + offset, sizeof(record));
+			offset += sizeof(record);
+			Event event;
+			event.type = record.type;
+			event.source = record.source;
+			event.down = record.down;
+			event.code = record.code;
+			event.x = record.x;
+			event.y = record.y;
+			m_events.push_back(event);
+		}
+		m_frames.push_back(frame);
+	}
+	m_report.frames.reserve(m_frames.size());
+	return true;
+}
+
+void InputReplayer::applyNextFrame(ImGuiIO &io, float fixedDeltaTime) {
+	if (isFinished())
+		return;
+	const Frame &frame = m_frames[m_next++];
+	io.DisplaySize = ImVec2(frame.displayWidth, frame.displayHeight);
+	float deltaTime = fixedDeltaTime > 0.0f ? fixedDeltaTime : frame.deltaTime;
+	// ImGui asserts on a non-positive delta
+	io.DeltaTime = deltaTime > 0.0f ? deltaTime : 1.0f / 60.0f;
+
+	for (uint32_t i = 0; i < frame.eventCount; i++) {
+		const Event &event = m_events[frame.firstEvent + i];
+		const ImGuiMouseSource source =
+			static_cast<ImGuiMouseSource>(event.source);
+		switch (event.type) {
+		case EventMousePos:
+			io.AddMouseSourceEvent(source);
+			io.AddMousePosEvent(event.x, event.y);
+			break;
+		case EventMouseWheel:
+			io.AddMouseSourceEvent(source);
+			io.AddMouseWheelEvent(event.x, event.y);
+			break;
+		case EventMouseButton:
+			io.AddMouseSourceEvent(source);
+			io.AddMouseButtonEvent(event.code, event.down != 0);
+			break;
+		case EventKey:
+			io.AddKeyAnalogEvent(static_cast<ImGuiKey>(event.code),
+								 event.down != 0, event.x);
+			break;
+		case EventText:
+			io.AddInputCharacter(static_cast<unsigned int>(event.code));
+			break;
+		case EventFocus:
+			io.AddFocusEvent(event.down != 0);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void InputReplayer::recordResult(double cpuMs, const ImDrawData *drawData) {
+	InputReplayReport::Frame frame;
+	frame.cpuMs = cpuMs;
+	frame.drawHash = hashDrawData(drawData);
+	if (drawData) {
+		frame.drawLists = static_cast<uint32_t>(drawData->CmdListsCount);
+		frame.vertices = static_cast<uint32_t>(drawData->TotalVtxCount);
+		frame.indices = static_cast<uint32_t>(drawData->TotalIdxCount);
+		for (int i = 0; i < drawData->CmdListsCount; i++)
+			frame.drawCommands += static_cast<uint32_t>(
+				drawData->CmdLists[i]->CmdBuffer.Size);
+	}
+	m_report.frames.push_back(frame);
+	m_report.combinedHash =
+		fnv1a(m_report.frames.size() == 1 ? kFnvBasis : m_report.combinedHash,
+			  &frame.drawHash, sizeof(frame.drawHash));
+}
+
+uint64_t InputReplayer::hashDrawData(const ImDrawData *drawData) {
+	uint64_t hash = kFnvBasis;
+	if (!drawData)
+		return hash;
+	hash = fnv1a(hash, &drawData->DisplaySize, sizeof(drawData->DisplaySize));
+	for (int i = 0; i < drawData->CmdListsCount; i++) {
+		const ImDrawList *list = drawData->CmdLists[i];
+		hash = fnv1a(hash, list->VtxBuffer.Data,
+					 size_t(list->VtxBuffer.Size) * sizeof(ImDrawVert));
+		hash = fnv1a(hash, list->IdxBuffer.Data,
+					 size_t(list->IdxBuffer.Size) * sizeof(ImDrawIdx));
+		for (const ImDrawCmd &cmd : list->CmdBuffer) {
+			const uint32_t fields[4] = {cmd.ElemCount, cmd.IdxOffset,
+										cmd.VtxOffset,
+										cmd.UserCallback != nullptr};
+			hash = fnv1a(hash, &cmd.ClipRect, sizeof(cmd.ClipRect));
+			hash = fnv1a(hash, fields, sizeof(fields));
+		}
+	}
+	return hash;
+}
+
+} // namespace blot
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct ImDrawData;
+struct ImGuiContext;
+struct ImGuiIO;
+
+namespace blot {
+
+// Binary stream of what the platform backend fed ImGui each frame: delta
+// time, display size and the input events (mouse, keys, text, focus) queued
+// since the previous frame. File layout: "BXIR" magic and version, then per
+// frame a FrameHeader followed by eventCount events, each a type byte and a
+// fixed payload. Replaying needs the UI to start from the state it was
+// recorded in (same windows, workspace and fonts).
+class InputRecorder {
+  public:
+	InputRecorder() = default;
+	~InputRecorder();
+
+	InputRecorder(const InputRecorder &) = delete;
+	InputRecorder &operator=(const InputRecorder &) = delete;
+
+	bool open(const std::string &path);
+	void close();
+	bool isOpen() const { return m_file != nullptr; }
+	const std::string &getError() const { return m_error; }
+	uint64_t getFrameCount() const { return m_frames; }
+
+	// Call after the backend's NewFrame and before ImGui::NewFrame(), which
+	// consumes the queue. Events still queued from an earlier frame (input
+	// trickling) are recognized by id and not written twice.
+	void recordFrame(ImGuiContext &context);
+
+  private:
+	void flush();
+
+	std::FILE *m_file = nullptr;
+	std::vector<uint8_t> m_buffer;
+	uint32_t m_lastEventId = 0;
+	uint64_t m_frames = 0;
+	std::string m_error;
+};
+
+// Per-frame results of a replay: CPU time of the frame (NewFrame through
+// Render) and a hash of its draw data, so two runs can be compared both for
+// speed and for identical output.
+struct InputReplayReport {
+	struct Frame {
+		double cpuMs = 0.0;
+		uint64_t drawHash = 0;
+		uint32_t drawLists = 0;
+		uint32_t drawCommands = 0;
+		uint32_t vertices = 0;
+		uint32_t indices = 0;
+	};
+
+	std::vector<Frame> frames;
+	// Hash over every frame's draw hash
+	uint64_t combinedHash = 0;
+
+	double getTotalMs() const;
+	double getMeanMs() const;
+	// percentile in [0, 100]
+	double getPercentileMs(double percentile) const;
+	double getMaxMs() const;
+	// One CSV row per frame followed by summary comment lines
+	bool writeCsv(const std::string &path) const;
+};
+
+// Plays an InputRecorder stream back into ImGuiIO one frame at a time
+class InputReplayer {
+  public:
+	bool load(const std::string &path);
+	const std::string &getError() const { return m_error; }
+	size_t getFrameCount() const { return m_frames.size(); }
+	bool isFinished() const { return m_next >= m_frames.size(); }
+
+	// Sets display size and delta time (fixedDeltaTime when > 0, otherwise
+	// the recorded one) and queues the next frame's events
+	void applyNextFrame(ImGuiIO &io, float fixedDeltaTime);
+	// Call after ImGui::Render() for the frame applyNextFrame() set up
+	void recordResult(double cpuMs, const ImDrawData *drawData);
+	const InputReplayReport &getReport() const { return m_report; }
+
+	// FNV-1a over vertices, indices, clip rectangles and element counts.
+	// Texture ids are left out: they differ between runs and renderers.
+	static uint64_t hashDrawData(const ImDrawData *drawData);
+
+  private:
+	struct Event {
+		uint8_t type = 0;
+		uint8_t source = 0; // ImGuiMouseSource for mouse events
+		uint8_t down = 0;
+		int32_t code = 0; // key, button or character
+		float x = 0.0f;   // position, wheel delta or analog value
+		float y = 0.0f;
+	};
+	struct Frame {
+		float deltaTime = 0.0f;
+		float displayWidth = 0.0f;
+		float displayHeight = 0.0f;
+		uint32_t firstEvent = 0;
+		uint32_t eventCount = 0;
+	};
+
+	std::vector<Frame> m_frames;
+	std::vector<Event> m_events;
+	size_t m_next = 0;
+	InputReplayReport m_report;
+	std::string m_error;
+};
+
+} // namespace blot
@@ -0,0 +1,211 @@
+#include "LogSearch.h"
+#include <algorithm>
+#include <cctype>
+#include <regex>
+
+namespace blot {
+
+// How often (in records) a running search checks whether it was replaced
+static constexpr uint32_t kCancelCheckInterval = 1024;
+
+bool LogSearch::Query::operator==(const Query &other) const {
+	return text == other.text && regex == other.regex &&
+		   caseSensitive == other.caseSensitive &&
+		   levelMask == other.levelMask && loggerId == other.loggerId &&
+		   threadId == other.threadId && sourceId == other.sourceId;
+}
+
+LogSearch::LogSearch() : m_worker([this]() { workerLoop(); }) {}
+
+LogSearch::~LogSearch() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+		m_jobs.clear();
+	}
+	m_generation.fetch_add(1);
+	m_wake.notify_one();
+	m_worker.join();
+}
+
+void LogSearch::start(const Query &query,
+					  std::vector<std::shared_ptr<LogChunk>> chunks,
+					  uint64_t beginSeq, uint64_t endSeq) {
+	Job job;
+	job.generation = m_generation.fetch_add(1) + 1;
+	job.query = query;
+	job.chunks = std::move(chunks);
+	job.beginSeq = beginSeq;
+	job.endSeq = endSeq;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_query = query;
+		m_jobs.clear();
+		m_results.clear();
+		m_error.clear();
+		m_chunksDone = 0;
+		m_chunksTotal = static_cast<uint32_t>(job.chunks.size());
+		m_jobs.push_back(std::move(job));
+	}
+	m_wake.notify_one();
+}
+
+void LogSearch::extend(std::vector<std::shared_ptr<LogChunk>> chunks,
+					   uint64_t beginSeq, uint64_t endSeq) {
+	Job job;
+	job.generation = m_generation.load();
+	job.chunks = std::move(chunks);
+	job.beginSeq = beginSeq;
+	job.endSeq = endSeq;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		job.query = m_query;
+		m_chunksTotal += static_cast<uint32_t>(job.chunks.size());
+		m_jobs.push_back(std::move(job));
+	}
+	m_wake.notify_one();
+}
+
+void LogSearch::cancel() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_generation.fetch_add(1);
+	m_jobs.clear();
+	m_results.clear();
+	m_chunksDone = 0;
+	m_chunksTotal = 0;
+}
+
+size_t LogSearch::takeResults(std::vector<uint64_t> &out) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t count = m_results.size();
+	out.insert(out.end(), m_results.begin(), m_results.end());
+	m_results.clear();
+	return count;
+}
+
+bool LogSearch::isRunning() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_busy || !m_jobs.empty();
+}
+
+float LogSearch::getProgress() const {
+	uint32_t total = m_chunksTotal.load();
+	return total > 0 ? static_cast<float>(m_chunksDone.load()) / total : 1.0f;
+}
+
+std::string LogSearch::getError() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_error;
+}
+
+void LogSearch::workerLoop() {
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_busy = false;
+			m_wake.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+			if (m_stop)
+				return;
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+			m_busy = true;
+		}
+		runJob(job);
+	}
+}
+
+namespace {
+bool containsIgnoreCase(const char *text, size_t length,
+						const std::string &needle) {
+	auto equal = [](char a, char b) {
+		return std::tolower(static_cast<unsigned char>(a)) ==
+			   std::tolower(static_cast<unsigned char>(b));
+	};
+	return std::search(text, text + length, needle.begin(), needle.end(),
+					   equal) != text + length;
+}
+} // namespace
+
+void LogSearch::runJob(const Job &job) {
+	const Query &query = job.query;
+	const bool useRegex = query.regex && !query.text.empty();
+	std::regex pattern;
+	if (useRegex) {
+		try {
+			auto flags = std::regex::ECMAScript | std::regex::optimize;
+			if (!query.caseSensitive)
+				flags |= std::regex::icase;
+			pattern.assign(query.text, flags);
+		} catch (const std::regex_error &e) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_error = e.what();
+			return;
+		}
+	}
+
+	// Trigrams every matching line must contain (plain text only)
+	std::vector<uint32_t> trigrams;
+	if (!useRegex) {
+		const auto *text =
+			reinterpret_cast<const unsigned char *>(query.text.data());
+		for (size_t i = 2; i < query.text.size(); i++)
+			trigrams.push_back(
+				LogChunk::trigramHash(text[i - 2], text[i - 1], text[i]));
+	}
+
+	std::vector<uint64_t> found;
+	for (const auto &chunkPtr : job.chunks) {
+		LogChunk &chunk = *chunkPtr;
+		if (!trigrams.empty()) {
+			chunk.extendBloom();
+			if (!chunk.bloomMayContain(trigrams.data(), trigrams.size())) {
+				m_chunksDone++;
+				continue;
+			}
+		}
+		uint64_t first = (std::max)(job.beginSeq, chunk.firstSeq());
+		uint64_t last = (std::min)(job.endSeq,
+								   chunk.firstSeq() + chunk.size());
+		for (uint64_t seq = first; seq < last; seq++) {
+			if ((seq - first) % kCancelCheckInterval == 0 &&
+				m_generation.load(std::memory_order_relaxed) !=
+					job.generation)
+				return;
+			const LogRecord &record =
+				chunk.record(static_cast<uint32_t>(seq - chunk.firstSeq()));
+			if (!(query.levelMask & (1 << static_cast<int>(record.level))) ||
+				(query.loggerId >= 0 && record.loggerId != query.loggerId) ||
+				(query.threadId >= 0 && record.threadId != query.threadId) ||
+				(query.sourceId >= 0 && record.sourceId != query.sourceId))
+				continue;
+			const char *text = chunk.text(record);
+			bool match = true;
+			if (useRegex) {
+				match = std::regex_search(text, text + record.textLength,
+										  pattern);
+			} else if (!query.text.empty()) {
+				match = query.caseSensitive
+							? std::search(text, text + record.textLength,
+										  query.text.begin(),
+										  query.text.end()) !=
+								  text + record.textLength
+							: containsIgnoreCase(text, record.textLength,
+												 query.text);
+			}
+			if (match)
+				found.push_back(seq);
+		}
+		// Stream this chunk's matches unless the search was replaced
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_generation.load() != job.generation)
+				return;
+			m_results.insert(m_results.end(), found.begin(), found.end());
+		}
+		found.clear();
+		m_chunksDone++;
+	}
+}
+
+} // namespace blot
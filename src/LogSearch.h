@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LogStore.h"
+
+namespace blot {
+
+// Runs LogWindow searches on a background thread. A search walks a snapshot
+// of LogStore chunks, skipping chunks whose trigram bloom filter rules the
+// query out, and streams matching sequence numbers back in ascending order.
+// extend() continues the current search over lines that arrived later.
+class LogSearch {
+  public:
+	struct Query {
+		std::string text;
+		bool regex = false;
+		bool caseSensitive = false;
+		int levelMask = 0xF; // bit per LogLevel
+		int loggerId = -1;	 // -1 = any
+		int threadId = -1;
+		int sourceId = -1;
+
+		// True when the query narrows more than the level mask does
+		bool isActive() const {
+			return !text.empty() || loggerId >= 0 || threadId >= 0 ||
+				   sourceId >= 0;
+		}
+		bool operator==(const Query &other) const;
+		bool operator!=(const Query &other) const { return !(*this == other); }
+	};
+
+	LogSearch();
+	~LogSearch();
+
+	LogSearch(const LogSearch &) = delete;
+	LogSearch &operator=(const LogSearch &) = delete;
+
+	// Replace the current search; previous results are discarded
+	void start(const Query &query,
+			   std::vector<std::shared_ptr<LogChunk>> chunks,
+			   uint64_t beginSeq, uint64_t endSeq);
+	// Search [beginSeq, endSeq) with the current query, appending results
+	void extend(std::vector<std::shared_ptr<LogChunk>> chunks,
+				uint64_t beginSeq, uint64_t endSeq);
+	void cancel();
+
+	// Appends results found since the last call; UI thread
+	size_t takeResults(std::vector<uint64_t> &out);
+	bool isRunning() const;
+	float getProgress() const;
+	std::string getError() const;
+
+  private:
+	struct Job {
+		uint64_t generation = 0;
+		Query query;
+		std::vector<std::shared_ptr<LogChunk>> chunks;
+		uint64_t beginSeq = 0;
+		uint64_t endSeq = 0;
+	};
+
+	void workerLoop();
+	void runJob(const Job &job);
+
+	std::thread m_worker;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::deque<Job> m_jobs;
+	Query m_query;
+	bool m_stop = false;
+	bool m_busy = false;
+	std::string m_error;
+	std::vector<uint64_t> m_results;
+
+	std::atomic<uint64_t> m_generation{0};
+	std::atomic<uint32_t> m_chunksDone{0};
+	std::atomic<uint32_t> m_chunksTotal{0};
+};
+
+} // namespace blot
@@ -0,0 +1,340 @@
+#include "LogSpill.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include "MappedFile.h"
+
+namespace blot {
+
+namespace {
+
+constexpr char kSegmentMagic[4] = {'B', 'X', 'L', 'G'};
+constexpr uint32_t kSegmentVersion = 1;
+constexpr const char *kSegmentExtension = ".bxlog";
+
+struct SegmentHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t firstSeq;
+	uint32_t recordCount;
+	uint32_t textSize;
+	uint32_t repeatCount;
+	uint32_t reserved;
+};
+static_assert(sizeof(SegmentHeader) == 32, "segment header layout");
+
+struct RepeatEntry {
+	uint32_t index;
+	uint32_t count;
+	int64_t lastTimeNs;
+};
+
+// Repeat table follows the text, 8-byte aligned
+size_t repeatOffset(const SegmentHeader &header) {
+	size_t end = sizeof(SegmentHeader) +
+				 sizeof(LogRecord) * header.recordCount + header.textSize;
+	return (end + 7) & ~size_t(7);
+}
+
+} // namespace
+
+LogSpill::LogSpill(const std::string &directory, uint64_t maxBytes)
+	: m_directory(directory), m_maxBytes(maxBytes) {
+	// Started here so every member is constructed before the thread runs
+	m_writer = std::thread([this]() { writerLoop(); });
+}
+
+LogSpill::~LogSpill() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_one();
+	m_writer.join();
+	// Scrollback does not outlive the session. Segments still mapped by a
+	// reader fail to delete on Windows; the next session removes them.
+	m_cache.clear();
+	std::error_code error;
+	for (const auto &segment : m_segments)
+		std::filesystem::remove(segment->path, error);
+	for (const std::string &path : m_deleteQueue)
+		std::filesystem::remove(path, error);
+	std::filesystem::remove(m_directory, error);
+}
+
+void LogSpill::spill(std::shared_ptr<LogChunk> chunk) {
+	auto segment = std::make_shared<Segment>();
+	segment->firstSeq = chunk->firstSeq();
+	segment->count = chunk->size();
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx%s",
+			 static_cast<unsigned long long>(segment->firstSeq),
+			 kSegmentExtension);
+	segment->path = (std::filesystem::path(m_directory) / name).string();
+	segment->pending = std::move(chunk);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_segments.push_back(segment);
+		m_writeQueue.push_back(std::move(segment));
+	}
+	m_wake.notify_one();
+}
+
+void LogSpill::clear() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (const auto &segment : m_segments) {
+			segment->dropped = true;
+			if (!segment->pending)
+				m_deleteQueue.push_back(segment->path);
+		}
+		m_segments.clear();
+		m_diskUsage = 0;
+	}
+	m_cache.clear();
+	m_wake.notify_one();
+}
+
+uint64_t LogSpill::beginSeq() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_segments.empty() ? UINT64_MAX : m_segments.front()->firstSeq;
+}
+
+uint64_t LogSpill::getDiskUsage() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_diskUsage;
+}
+
+size_t LogSpill::getSegmentCount() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_segments.size();
+}
+
+std::string LogSpill::getError() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_error;
+}
+
+std::shared_ptr<LogChunk> LogSpill::chunkFor(uint64_t seq) {
+	for (auto it = m_cache.begin(); it != m_cache.end(); ++it) {
+		const LogChunk &chunk = **it;
+		if (seq >= chunk.firstSeq() && seq < chunk.firstSeq() + chunk.size()) {
+			if (it != m_cache.begin())
+				std::rotate(m_cache.begin(), it, it + 1);
+			return m_cache.front();
+		}
+	}
+
+	std::shared_ptr<Segment> segment;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = std::upper_bound(
+			m_segments.begin(), m_segments.end(), seq,
+			[](uint64_t value, const std::shared_ptr<Segment> &segment) {
+				return value < segment->firstSeq;
+			});
+		if (it != m_segments.begin() &&
+			seq < (*(it - 1))->firstSeq + (*(it - 1))->count) {
+			segment = *(it - 1);
+			// Not written yet: serve the chunk from memory
+			if (segment->pending)
+				return segment->pending;
+		}
+	}
+
+	std::shared_ptr<LogChunk> chunk =
+		segment ? mapSegment(*segment) : nullptr;
+	if (!chunk) {
+		chunk = segment ? emptyChunk(segment->firstSeq, segment->count)
+						: emptyChunk(seq, 1);
+	}
+	m_cache.push_front(chunk);
+	if (m_cache.size() > kCacheSize)
+		m_cache.pop_back();
+	return chunk;
+}
+
+std::vector<std::shared_ptr<LogChunk>>
+LogSpill::chunksIn(uint64_t beginSeq, uint64_t endSeq) {
+	std::vector<std::shared_ptr<LogChunk>> chunks;
+	uint64_t seq = (std::max)(beginSeq, this->beginSeq());
+	while (seq < endSeq) {
+		std::shared_ptr<LogChunk> chunk = chunkFor(seq);
+		seq = chunk->firstSeq() + chunk->size();
+		chunks.push_back(std::move(chunk));
+	}
+	return chunks;
+}
+
+std::shared_ptr<LogChunk> LogSpill::emptyChunk(uint64_t firstSeq,
+											   uint32_t count) {
+	auto chunk = std::make_shared<LogChunk>(firstSeq, 0);
+	LogRecord record;
+	for (uint32_t i = 0; i < count; i++)
+		chunk->tryAppend(record, "", 0);
+	return chunk;
+}
+
+std::shared_ptr<LogChunk> LogSpill::mapSegment(const Segment &segment) {
+	std::shared_ptr<MappedFile> file = MappedFile::open(segment.path);
+	if (!file || file->size() < sizeof(SegmentHeader))
+		return nullptr;
+	SegmentHeader header;
+	std::memcpy(&header, file->data(), sizeof(header));
+	if (std::memcmp(header.magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0 ||
+		header.version != kSegmentVersion ||
+		header.firstSeq != segment.firstSeq ||
+		header.recordCount != segment.count ||
+		header.recordCount > LogChunk::kRecordCapacity ||
+		file->size() < repeatOffset(header) +
+						   sizeof(RepeatEntry) * header.repeatCount)
+		return nullptr;
+
+	const char *data = file->data();
+	auto records = reinterpret_cast<const LogRecord *>(
+		data + sizeof(SegmentHeader));
+	const char *text = data + sizeof(SegmentHeader) +
+					   sizeof(LogRecord) * header.recordCount;
+	auto repeats =
+		reinterpret_cast<const RepeatEntry *>(data + repeatOffset(header));
+	auto chunk = std::make_shared<LogChunk>(header.firstSeq, records,
+											header.recordCount, text,
+											header.textSize, std::move(file));
+	for (uint32_t i = 0; i < header.repeatCount; i++) {
+		if (repeats[i].index >= header.recordCount)
+			continue;
+		LogRepeat &repeat = chunk->addRepeat(repeats[i].index);
+		repeat.count = repeats[i].count;
+		repeat.lastTimeNs = repeats[i].lastTimeNs;
+	}
+	return chunk;
+}
+
+bool LogSpill::writeSegment(const Segment &segment, const LogChunk &chunk) {
+	std::FILE *file = std::fopen(segment.path.c_str(), "wb");
+	if (!file) {
+		// The directory may have been removed under a running session
+		std::error_code error;
+		std::filesystem::create_directories(m_directory, error);
+		file = std::fopen(segment.path.c_str(), "wb");
+	}
+	if (!file)
+		return false;
+	SegmentHeader header = {};
+	std::memcpy(header.magic, kSegmentMagic, sizeof(kSegmentMagic));
+	header.version = kSegmentVersion;
+	header.firstSeq = chunk.firstSeq();
+	header.recordCount = chunk.size();
+	header.textSize = chunk.textSize();
+	header.repeatCount = static_cast<uint32_t>(chunk.repeats().size());
+
+	std::vector<RepeatEntry> repeats;
+	repeats.reserve(header.repeatCount);
+	for (const auto &entry : chunk.repeats())
+		repeats.push_back(
+			{entry.first, entry.second.count, entry.second.lastTimeNs});
+
+	static const char padding[8] = {};
+	size_t textEnd = sizeof(SegmentHeader) +
+					 sizeof(LogRecord) * header.recordCount + header.textSize;
+	bool ok =
+		std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+		(header.recordCount == 0 ||
+		 std::fwrite(&chunk.record(0), sizeof(LogRecord), header.recordCount,
+					 file) == header.recordCount) &&
+		std::fwrite(chunk.textData(), 1, header.textSize, file) ==
+			header.textSize &&
+		std::fwrite(padding, 1, repeatOffset(header) - textEnd, file) ==
+			repeatOffset(header) - textEnd &&
+		(repeats.empty() ||
+		 std::fwrite(repeats.data(), sizeof(RepeatEntry), repeats.size(),
+					 file) == repeats.size());
+	ok = std::fclose(file) == 0 && ok;
+	return ok;
+}
+
+void LogSpill::writerLoop() {
+	// Start from an empty directory: segments of an earlier session would
+	// collide with this one's names
+	std::error_code error;
+	std::filesystem::create_directories(m_directory, error);
+	for (const auto &entry :
+		 std::filesystem::directory_iterator(m_directory, error)) {
+		if (entry.path().extension() == kSegmentExtension)
+			std::filesystem::remove(entry.path(), error);
+	}
+
+	while (true) {
+		std::shared_ptr<Segment> segment;
+		std::vector<std::string> deletions;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this]() {
+				return m_stop || !m_writeQueue.empty() ||
+					   !m_deleteQueue.empty();
+			});
+			if (m_stop)
+				return;
+			deletions.swap(m_deleteQueue);
+			if (!m_writeQueue.empty()) {
+				segment = std::move(m_writeQueue.front());
+				m_writeQueue.pop_front();
+			}
+		}
+		// Deleting a segment that is still mapped fails on Windows; such
+		// files are left for the next session's cleanup
+		for (const std::string &path : deletions)
+			std::filesystem::remove(path, error);
+		if (!segment)
+			continue;
+
+		std::shared_ptr<LogChunk> chunk;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!segment->dropped)
+				chunk = segment->pending;
+		}
+		if (!chunk)
+			continue;
+		bool written = writeSegment(*segment, *chunk);
+		std::error_code sizeError;
+		uint64_t bytes = written ? std::filesystem::file_size(segment->path,
+															  sizeError)
+								 : 0;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (segment->dropped) {
+			// Cleared while writing
+			m_deleteQueue.push_back(segment->path);
+			continue;
+		}
+		if (!written) {
+			// History can't have holes: drop everything up to this segment
+			m_error = "Failed to write " + segment->path;
+			while (!m_segments.empty() &&
+				   m_segments.front()->firstSeq <= segment->firstSeq) {
+				m_segments.front()->dropped = true;
+				if (!m_segments.front()->pending)
+					m_deleteQueue.push_back(m_segments.front()->path);
+				m_diskUsage -= m_segments.front()->bytes;
+				m_segments.pop_front();
+			}
+			m_deleteQueue.push_back(segment->path);
+			continue;
+		}
+		segment->bytes = bytes;
+		segment->pending.reset();
+		m_diskUsage += bytes;
+		// Rotate: keep the newest segments within the disk cap
+		while (m_diskUsage > m_maxBytes && m_segments.size() > 1 &&
+			   !m_segments.front()->pending) {
+			m_diskUsage -= m_segments.front()->bytes;
+			m_deleteQueue.push_back(m_segments.front()->path);
+			m_segments.pop_front();
+		}
+	}
+}
+
+} // namespace blot
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LogStore.h"
+
+namespace blot {
+
+// Keeps chunks evicted from a LogStore on disk. Chunks are written to
+// segment files (one chunk per segment: header, LogRecords, text, repeat
+// table) by a background thread and memory-mapped back in on demand. Once
+// the segments exceed the disk cap the oldest ones are deleted.
+//
+// The directory is owned by the spill: stale segments from an earlier
+// session are removed on startup, its segments (and the directory, once
+// empty) on destruction, and two spills must not share it.
+class LogSpill {
+  public:
+	static constexpr uint64_t kDefaultMaxBytes = 256ull * 1024 * 1024;
+
+	LogSpill(const std::string &directory,
+			 uint64_t maxBytes = kDefaultMaxBytes);
+	~LogSpill();
+
+	LogSpill(const LogSpill &) = delete;
+	LogSpill &operator=(const LogSpill &) = delete;
+
+	// UI thread; chunks must arrive in sequence order. The chunk stays
+	// readable from memory until its segment is written.
+	void spill(std::shared_ptr<LogChunk> chunk);
+	// Drop every segment; files are deleted by the writer
+	void clear();
+
+	// Oldest spilled sequence still available, or UINT64_MAX when empty
+	uint64_t beginSeq() const;
+	// UI thread. Never null: a segment that is gone (rotated away, failed to
+	// map) is replaced by empty records.
+	std::shared_ptr<LogChunk> chunkFor(uint64_t seq);
+	// Chunks overlapping [beginSeq, endSeq), mapped as needed
+	std::vector<std::shared_ptr<LogChunk>> chunksIn(uint64_t beginSeq,
+													uint64_t endSeq);
+
+	const std::string &getDirectory() const { return m_directory; }
+	uint64_t getMaxBytes() const { return m_maxBytes; }
+	uint64_t getDiskUsage() const;
+	size_t getSegmentCount() const;
+	std::string getError() const;
+
+  private:
+	struct Segment {
+		uint64_t firstSeq = 0;
+		uint32_t count = 0;
+		uint64_t bytes = 0;
+		std::string path;
+		std::shared_ptr<LogChunk> pending; // until the segment is written
+		bool dropped = false;
+	};
+
+	void writerLoop();
+	bool writeSegment(const Segment &segment, const LogChunk &chunk);
+	std::shared_ptr<LogChunk> mapSegment(const Segment &segment);
+	static std::shared_ptr<LogChunk> emptyChunk(uint64_t firstSeq,
+												uint32_t count);
+
+	std::string m_directory;
+	uint64_t m_maxBytes;
+
+	std::thread m_writer;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::deque<std::shared_ptr<Segment>> m_segments; // ordered by firstSeq
+	std::deque<std::shared_ptr<Segment>> m_writeQueue;
+	std::vector<std::string> m_deleteQueue;
+	uint64_t m_diskUsage = 0;
+	std::string m_error;
+	bool m_stop = false;
+
+	// Recently mapped segments, most recent first; UI thread only
+	static constexpr size_t kCacheSize = 8;
+	std::deque<std::shared_ptr<LogChunk>> m_cache;
+};
+
+} // namespace blot
@@ -0,0 +1,348 @@
+#include "LogStore.h"
+#include "LogSpill.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+
+namespace blot {
+
+static constexpr size_t kMaxFacetIds = std::numeric_limits<uint16_t>::max();
+
+LogChunk::LogChunk(uint64_t firstSeq, uint32_t textCapacity)
+	: m_firstSeq(firstSeq), m_ownedRecords(new LogRecord[kRecordCapacity]),
+	  m_ownedText(new char[textCapacity]), m_records(m_ownedRecords.get()),
+	  m_text(m_ownedText.get()), m_textCapacity(textCapacity) {}
+
+LogChunk::LogChunk(uint64_t firstSeq, const LogRecord *records,
+				   uint32_t count, const char *text, uint32_t textSize,
+				   std::shared_ptr<const void> backing)
+	: m_firstSeq(firstSeq), m_backing(std::move(backing)), m_records(records),
+	  m_text(text), m_textCapacity(textSize), m_textUsed(textSize),
+	  m_count(count) {}
+
+size_t LogChunk::memoryUsage() const {
+	// Mapped chunks only count what lives on the heap
+	size_t bytes = sizeof(LogChunk) + (m_lineCounts ? kRecordCapacity * 2 : 0);
+	if (m_ownedRecords)
+		bytes += sizeof(LogRecord) * kRecordCapacity + m_textCapacity;
+	return bytes;
+}
+
+bool LogChunk::tryAppend(const LogRecord &record, const char *text,
+						 uint32_t length) {
+	uint32_t count = m_count.load(std::memory_order_relaxed);
+	if (!m_ownedRecords || count == kRecordCapacity ||
+		m_textCapacity - m_textUsed < length)
+		return false;
+	LogRecord &slot = m_ownedRecords[count];
+	slot = record;
+	slot.textOffset = m_textUsed;
+	slot.textLength = length;
+	std::memcpy(m_ownedText.get() + m_textUsed, text, length);
+	m_textUsed += length;
+	// Publish after the record and its text are written
+	m_count.store(count + 1, std::memory_order_release);
+	return true;
+}
+
+uint16_t *LogChunk::lineCounts(float width) {
+	if (!m_lineCounts)
+		m_lineCounts.reset(new uint16_t[kRecordCapacity]);
+	if (width != m_lineWidth) {
+		std::fill_n(m_lineCounts.get(), kRecordCapacity, uint16_t(0));
+		m_lineWidth = width;
+	}
+	return m_lineCounts.get();
+}
+
+uint32_t LogChunk::trigramHash(unsigned char a, unsigned char b,
+							   unsigned char c) {
+	uint32_t key = (uint32_t(std::tolower(a)) << 16) |
+				   (uint32_t(std::tolower(b)) << 8) | uint32_t(std::tolower(c));
+	return key * 0x9E3779B1u;
+}
+
+void LogChunk::extendBloom() {
+	uint32_t count = size();
+	if (m_bloomRecords == count)
+		return;
+	if (!m_bloom) {
+		m_bloom.reset(new uint64_t[kBloomBits / 64]);
+		std::fill_n(m_bloom.get(), kBloomBits / 64, uint64_t(0));
+	}
+	for (; m_bloomRecords < count; m_bloomRecords++) {
+		const LogRecord &rec = m_records[m_bloomRecords];
+		auto text = reinterpret_cast<const unsigned char *>(this->text(rec));
+		for (uint32_t i = 2; i < rec.textLength; i++) {
+			uint32_t hash = trigramHash(text[i - 2], text[i - 1], text[i]);
+			// Two probes from one hash: low and high halves
+			uint32_t bit0 = hash & (kBloomBits - 1);
+			uint32_t bit1 = (hash >> 15) & (kBloomBits - 1);
+			m_bloom[bit0 >> 6] |= uint64_t(1) << (bit0 & 63);
+			m_bloom[bit1 >> 6] |= uint64_t(1) << (bit1 & 63);
+		}
+	}
+}
+
+bool LogChunk::bloomMayContain(const uint32_t *trigrams, size_t count) const {
+	if (!m_bloom)
+		return true;
+	for (size_t i = 0; i < count; i++) {
+		uint32_t bit0 = trigrams[i] & (kBloomBits - 1);
+		uint32_t bit1 = (trigrams[i] >> 15) & (kBloomBits - 1);
+		if (!(m_bloom[bit0 >> 6] & (uint64_t(1) << (bit0 & 63))) ||
+			!(m_bloom[bit1 >> 6] & (uint64_t(1) << (bit1 & 63))))
+			return false;
+	}
+	return true;
+}
+
+const LogRepeat *LogChunk::repeat(uint32_t index) const {
+	if (m_repeats.empty())
+		return nullptr;
+	auto it = m_repeats.find(index);
+	return it != m_repeats.end() ? &it->second : nullptr;
+}
+
+LogRepeat &LogChunk::addRepeat(uint32_t index) {
+	auto result = m_repeats.try_emplace(index);
+	if (result.second)
+		result.first->second.lastTimeNs = m_records[index].timeNs;
+	return result.first->second;
+}
+
+static uint64_t hashLine(const std::string &text, const LogRecord &record) {
+	// FNV-1a over the text, seeded with level and logger
+	uint64_t hash = 14695981039346656037ull ^
+					(uint64_t(record.level) << 16 | record.loggerId);
+	for (char c : text) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+bool LogStore::tryCoalesce(const PendingLogEntry &entry,
+						   const LogRecord &record, uint64_t hash) {
+	for (size_t i = 0; i < m_recentCount; i++) {
+		const RecentLine &recent = m_recent[i];
+		if (recent.hash != hash || recent.seq < m_beginSeq)
+			continue;
+		uint32_t index = 0;
+		LogChunk &chunk = chunkFor(recent.seq, index);
+		const LogRecord &previous = chunk.record(index);
+		if (previous.level != record.level ||
+			previous.loggerId != record.loggerId ||
+			previous.textLength != entry.message.size() ||
+			std::memcmp(chunk.text(previous), entry.message.data(),
+						previous.textLength) != 0)
+			continue;
+		LogRepeat &repeat = chunk.addRepeat(index);
+		if (repeat.count < std::numeric_limits<uint32_t>::max())
+			repeat.count++;
+		repeat.lastTimeNs = record.timeNs;
+		m_coalescedCount++;
+		return true;
+	}
+	return false;
+}
+
+LogStore::LogStore() = default;
+LogStore::~LogStore() = default;
+
+void LogStore::setSpill(const std::string &directory, uint64_t maxBytes) {
+	m_spilledChunk.reset();
+	if (directory.empty()) {
+		m_spill.reset();
+		return;
+	}
+	m_spill = std::make_unique<LogSpill>(directory, maxBytes);
+}
+
+uint64_t LogStore::historyBeginSeq() const {
+	return m_spill ? (std::min)(m_spill->beginSeq(), m_beginSeq)
+				   : m_beginSeq;
+}
+
+void LogStore::setRateLimit(double ratePerSecond, double burst) {
+	m_rateLimit = (std::max)(ratePerSecond, 0.0);
+	m_rateBurst = (std::max)(burst, 1.0);
+	// Buckets start full again under the new limit; drop counts are kept
+	for (RateBucket &bucket : m_rateBuckets)
+		bucket.primed = false;
+}
+
+bool LogStore::takeRateToken(const LogRecord &record) {
+	if (m_rateBuckets.size() <= record.loggerId)
+		m_rateBuckets.resize(size_t(record.loggerId) + 1);
+	RateBucket &bucket = m_rateBuckets[record.loggerId];
+	if (!bucket.primed) {
+		bucket.tokens = m_rateBurst;
+		bucket.lastTimeNs = record.timeNs;
+		bucket.primed = true;
+	}
+	// Refill from message time; lines from other threads may arrive
+	// slightly out of order, which must not drain the bucket
+	if (record.timeNs > bucket.lastTimeNs) {
+		double elapsed = double(record.timeNs - bucket.lastTimeNs) * 1e-9;
+		bucket.tokens =
+			(std::min)(bucket.tokens + elapsed * m_rateLimit, m_rateBurst);
+		bucket.lastTimeNs = record.timeNs;
+	}
+	if (bucket.tokens < 1.0) {
+		bucket.dropped++;
+		m_rateLimitedCount++;
+		return false;
+	}
+	bucket.tokens -= 1.0;
+	return true;
+}
+
+bool LogStore::append(const PendingLogEntry &entry) {
+	LogRecord record;
+	record.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+						entry.time.time_since_epoch())
+						.count();
+	record.level = entry.level;
+	record.loggerId = internLogger(entry.loggerName);
+	record.threadId = internThread(entry.threadId);
+	record.sourceId = internSource(entry.sourceFile, entry.sourceLine);
+
+	if (m_coalescing) {
+		uint64_t hash = hashLine(entry.message, record);
+		if (tryCoalesce(entry, record, hash))
+			return false;
+		if (m_rateLimit > 0.0 && !takeRateToken(record))
+			return false;
+		m_recent[m_recentNext] = RecentLine{m_endSeq, hash};
+		m_recentNext = (m_recentNext + 1) % m_recent.size();
+		m_recentCount = (std::min)(m_recentCount + 1, m_recent.size());
+	} else if (m_rateLimit > 0.0 && !takeRateToken(record)) {
+		return false;
+	}
+
+	auto length = static_cast<uint32_t>(entry.message.size());
+	if (m_chunks.empty() ||
+		!m_chunks.back()->tryAppend(record, entry.message.data(), length)) {
+		// Oversized messages get a chunk of their own
+		uint32_t capacity = (std::max)(LogChunk::kTextCapacity, length);
+		m_chunks.push_back(std::make_shared<LogChunk>(m_endSeq, capacity));
+		m_chunks.back()->tryAppend(record, entry.message.data(), length);
+	}
+	++m_endSeq;
+	evict();
+	return true;
+}
+
+void LogStore::clear() {
+	m_chunks.clear();
+	m_spilledChunk.reset();
+	if (m_spill)
+		m_spill->clear();
+	m_beginSeq = m_endSeq;
+	m_recentCount = 0;
+	m_recentNext = 0;
+}
+
+void LogStore::setMaxRecords(size_t maxRecords) {
+	m_maxRecords = (std::max)(maxRecords, size_t(1));
+	evict();
+}
+
+void LogStore::evict() {
+	// Drop whole chunks while the rest still satisfies the cap
+	while (m_chunks.size() > 1 &&
+		   size() - m_chunks.front()->size() >= m_maxRecords) {
+		if (m_spill)
+			m_spill->spill(m_chunks.front());
+		m_chunks.pop_front();
+		m_beginSeq = m_chunks.front()->firstSeq();
+	}
+}
+
+size_t LogStore::memoryUsage() const {
+	size_t bytes = 0;
+	for (const auto &chunk : m_chunks)
+		bytes += chunk->memoryUsage();
+	return bytes;
+}
+
+LogChunk &LogStore::chunkFor(uint64_t seq, uint32_t &index) {
+	if (seq < m_beginSeq && m_spill) {
+		m_spilledChunk = m_spill->chunkFor(seq);
+		index = static_cast<uint32_t>(seq - m_spilledChunk->firstSeq());
+		return *m_spilledChunk;
+	}
+	// Chunks are ordered by firstSeq; most lookups hit the newest ones
+	auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), seq,
+							   [](uint64_t value, const auto &chunk) {
+								   return value < chunk->firstSeq();
+							   });
+	LogChunk &chunk = **(it - 1);
+	index = static_cast<uint32_t>(seq - chunk.firstSeq());
+	return chunk;
+}
+
+std::vector<std::shared_ptr<LogChunk>> LogStore::chunksFrom(uint64_t seq) {
+	std::vector<std::shared_ptr<LogChunk>> chunks;
+	if (seq < m_beginSeq && m_spill)
+		chunks = m_spill->chunksIn(seq, m_beginSeq);
+	for (const auto &chunk : m_chunks) {
+		if (chunk->firstSeq() + chunk->size() > seq)
+			chunks.push_back(chunk);
+	}
+	return chunks;
+}
+
+const LogRecord &LogStore::record(uint64_t seq) {
+	uint32_t index = 0;
+	LogChunk &chunk = chunkFor(seq, index);
+	return chunk.record(index);
+}
+
+uint16_t LogStore::internLogger(const char *name) {
+	if (m_loggers[m_lastLogger] == name)
+		return m_lastLogger;
+	for (size_t i = 0; i < m_loggers.size(); i++) {
+		if (m_loggers[i] == name) {
+			m_lastLogger = static_cast<uint16_t>(i);
+			return m_lastLogger;
+		}
+	}
+	if (m_loggers.size() >= kMaxFacetIds)
+		return 0;
+	m_loggers.emplace_back(name);
+	m_lastLogger = static_cast<uint16_t>(m_loggers.size() - 1);
+	return m_lastLogger;
+}
+
+uint16_t LogStore::internThread(size_t threadId) {
+	if (m_threads[m_lastThread] == threadId)
+		return m_lastThread;
+	auto it = std::find(m_threads.begin(), m_threads.end(), threadId);
+	if (it == m_threads.end()) {
+		if (m_threads.size() >= kMaxFacetIds)
+			return 0;
+		it = m_threads.insert(it, threadId);
+	}
+	m_lastThread = static_cast<uint16_t>(it - m_threads.begin());
+	return m_lastThread;
+}
+
+uint16_t LogStore::internSource(const char *file, int line) {
+	if (!file)
+		return 0;
+	auto key = std::make_pair(file, line);
+	auto it = m_sourceIndex.find(key);
+	if (it != m_sourceIndex.end())
+		return it->second;
+	if (m_sources.size() >= kMaxFacetIds)
+		return 0;
+	auto id = static_cast<uint16_t>(m_sources.size());
+	m_sources.push_back(SourceLocation{file, line});
+	m_sourceIndex.emplace(key, id);
+	return id;
+}
+
+} // namespace blot
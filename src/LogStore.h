@@ -0,0 +1,240 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace blot {
+
+class LogSpill;
+
+enum class LogLevel : uint8_t { Debug, Info, Warning, Error };
+
+// Message as handed over by LogWindowSink; copied into a LogStore on the UI
+// thread
+struct PendingLogEntry {
+	LogLevel level = LogLevel::Info;
+	std::string message;
+	std::chrono::system_clock::time_point time;
+	size_t threadId = 0;
+	const char *sourceFile = nullptr; // __FILE__ literal, static storage
+	int sourceLine = 0;
+	char loggerName[32] = {};
+};
+
+// Compact per-line record; the text lives in the owning chunk's arena
+struct LogRecord {
+	int64_t timeNs = 0; // system_clock time since epoch
+	uint32_t textOffset = 0;
+	uint32_t textLength = 0;
+	uint16_t loggerId = 0;
+	uint16_t threadId = 0;
+	uint16_t sourceId = 0;
+	LogLevel level = LogLevel::Info;
+	uint8_t flags = 0;
+};
+
+// Occurrence count of a coalesced line and the time of its latest copy
+struct LogRepeat {
+	uint32_t count = 1;
+	int64_t lastTimeNs = 0;
+};
+
+// Fixed-capacity block of records plus their text. Appends come from a
+// single writer; the published count is atomic so other threads can read
+// records below it without locking.
+class LogChunk {
+  public:
+	static constexpr uint32_t kRecordCapacity = 4096;
+	static constexpr uint32_t kTextCapacity = 256 * 1024;
+
+	LogChunk(uint64_t firstSeq, uint32_t textCapacity = kTextCapacity);
+	// Read-only chunk over records and text owned by backing (a mapped
+	// LogSpill segment)
+	LogChunk(uint64_t firstSeq, const LogRecord *records, uint32_t count,
+			 const char *text, uint32_t textSize,
+			 std::shared_ptr<const void> backing);
+
+	uint64_t firstSeq() const { return m_firstSeq; }
+	uint32_t size() const { return m_count.load(std::memory_order_acquire); }
+	const LogRecord &record(uint32_t index) const { return m_records[index]; }
+	const char *text(const LogRecord &record) const {
+		return m_text + record.textOffset;
+	}
+	const char *textData() const { return m_text; }
+	uint32_t textSize() const { return m_textUsed; }
+	size_t memoryUsage() const;
+
+	// Writer only; false when the chunk has no room for the record
+	bool tryAppend(const LogRecord &record, const char *text, uint32_t length);
+
+	// Wrapped-line counts measured at lineWidth (UI thread only, 0 = not
+	// measured yet)
+	uint16_t *lineCounts(float width);
+
+	// Repeat info for coalesced records (UI thread only); nullptr when the
+	// record was seen once
+	const LogRepeat *repeat(uint32_t index) const;
+	LogRepeat &addRepeat(uint32_t index);
+	const std::unordered_map<uint32_t, LogRepeat> &repeats() const {
+		return m_repeats;
+	}
+
+	// Trigram bloom filter over the chunk's text, used by LogSearch to skip
+	// chunks. Built lazily and extended as records arrive; search thread only.
+	static constexpr uint32_t kBloomBits = 1u << 17;
+	void extendBloom();
+	bool bloomMayContain(const uint32_t *trigrams, size_t count) const;
+	static uint32_t trigramHash(unsigned char a, unsigned char b,
+								unsigned char c);
+
+  private:
+	uint64_t m_firstSeq;
+	std::unique_ptr<LogRecord[]> m_ownedRecords; // null when read-only
+	std::unique_ptr<char[]> m_ownedText;
+	std::shared_ptr<const void> m_backing;
+	const LogRecord *m_records;
+	const char *m_text;
+	uint32_t m_textCapacity;
+	uint32_t m_textUsed = 0;
+	std::atomic<uint32_t> m_count{0};
+	std::unique_ptr<uint16_t[]> m_lineCounts;
+	float m_lineWidth = -1.0f;
+	std::unique_ptr<uint64_t[]> m_bloom;
+	uint32_t m_bloomRecords = 0;
+	std::unordered_map<uint32_t, LogRepeat> m_repeats;
+};
+
+// Append-only log history made of LogChunks, addressed by a monotonically
+// increasing sequence number. Whole chunks are dropped from the front once
+// the retention cap is exceeded, or handed to a LogSpill when one is set.
+class LogStore {
+  public:
+	LogStore();
+	~LogStore();
+
+	struct SourceLocation {
+		const char *file = nullptr;
+		int line = 0;
+	};
+
+	// Returns false when the entry was not stored as a new record: either
+	// coalesced into a recent identical line or dropped by the rate limit
+	bool append(const PendingLogEntry &entry);
+	void clear();
+
+	// Collapse a line identical (text, level, logger) to one of the last
+	// kCoalesceWindow distinct lines into that line's repeat count
+	static constexpr size_t kCoalesceWindow = 8;
+	void setCoalescing(bool enabled) { m_coalescing = enabled; }
+	bool isCoalescing() const { return m_coalescing; }
+	uint64_t getCoalescedCount() const { return m_coalescedCount; }
+
+	// Per-logger token bucket applied to lines that would become new
+	// records (repeats are only counted). ratePerSecond <= 0 disables it.
+	void setRateLimit(double ratePerSecond, double burst);
+	double getRateLimit() const { return m_rateLimit; }
+	double getRateBurst() const { return m_rateBurst; }
+	uint64_t getRateLimitedCount() const { return m_rateLimitedCount; }
+	uint64_t getRateLimitedCount(uint16_t loggerId) const {
+		return loggerId < m_rateBuckets.size()
+				   ? m_rateBuckets[loggerId].dropped
+				   : 0;
+	}
+
+	// Records kept in memory; older chunks go to the spill, or are dropped
+	// without one. A few chunks keep RSS small while the spill holds the
+	// rest of the session.
+	static constexpr size_t kDefaultMaxRecords = 4 * LogChunk::kRecordCapacity;
+	void setMaxRecords(size_t maxRecords);
+	size_t getMaxRecords() const { return m_maxRecords; }
+
+	// Spill evicted chunks to segment files in directory (empty disables);
+	// see LogSpill
+	void setSpill(const std::string &directory, uint64_t maxBytes);
+	LogSpill *getSpill() const { return m_spill.get(); }
+
+	// In-memory sequence range [beginSeq, endSeq)
+	uint64_t beginSeq() const { return m_beginSeq; }
+	// Oldest sequence available at all, including spilled history
+	uint64_t historyBeginSeq() const;
+	uint64_t endSeq() const { return m_endSeq; }
+	size_t size() const { return static_cast<size_t>(m_endSeq - m_beginSeq); }
+	size_t memoryUsage() const;
+
+	// seq must be in [historyBeginSeq, endSeq). Spilled chunks are mapped
+	// on demand; the reference stays valid until the next call.
+	LogChunk &chunkFor(uint64_t seq, uint32_t &index);
+	// Chunks holding [seq, endSeq); shared so readers on other threads keep
+	// them alive past eviction
+	std::vector<std::shared_ptr<LogChunk>> chunksFrom(uint64_t seq);
+	const LogRecord &record(uint64_t seq);
+
+	// Interned facets
+	const std::string &loggerName(uint16_t id) const {
+		return m_loggers[id];
+	}
+	size_t threadId(uint16_t id) const { return m_threads[id]; }
+	SourceLocation sourceLocation(uint16_t id) const { return m_sources[id]; }
+	size_t loggerCount() const { return m_loggers.size(); }
+	size_t threadCount() const { return m_threads.size(); }
+	size_t sourceCount() const { return m_sources.size(); }
+
+  private:
+	uint16_t internLogger(const char *name);
+	uint16_t internThread(size_t threadId);
+	uint16_t internSource(const char *file, int line);
+	bool tryCoalesce(const PendingLogEntry &entry, const LogRecord &record,
+					 uint64_t hash);
+	bool takeRateToken(const LogRecord &record);
+	void evict();
+
+	std::deque<std::shared_ptr<LogChunk>> m_chunks;
+	std::unique_ptr<LogSpill> m_spill;
+	std::shared_ptr<LogChunk> m_spilledChunk; // keeps chunkFor's result alive
+	uint64_t m_beginSeq = 0;
+	uint64_t m_endSeq = 0;
+	size_t m_maxRecords = kDefaultMaxRecords;
+
+	// Id 0 is "unknown" in every table
+	std::vector<std::string> m_loggers{std::string()};
+	std::vector<size_t> m_threads{0};
+	std::vector<SourceLocation> m_sources{SourceLocation{}};
+	std::map<std::pair<const char *, int>, uint16_t> m_sourceIndex;
+	uint16_t m_lastLogger = 0;
+	uint16_t m_lastThread = 0;
+
+	// Recently appended lines considered for coalescing
+	struct RecentLine {
+		uint64_t seq = 0;
+		uint64_t hash = 0;
+	};
+	bool m_coalescing = true;
+	uint64_t m_coalescedCount = 0;
+	std::array<RecentLine, kCoalesceWindow> m_recent{};
+	size_t m_recentCount = 0;
+	size_t m_recentNext = 0;
+
+	// Token buckets indexed by logger id
+	struct RateBucket {
+		double tokens = 0.0;
+		int64_t lastTimeNs = 0;
+		uint64_t dropped = 0;
+		bool primed = false;
+	};
+	double m_rateLimit = 0.0;
+	double m_rateBurst = 0.0;
+	uint64_t m_rateLimitedCount = 0;
+	std::vector<RateBucket> m_rateBuckets;
+};
+
+} // namespace blot
@@ -0,0 +1,155 @@
+#include "LogThroughput.h"
+#include <algorithm>
+#include <cstring>
+
+namespace blot {
+
+static uint32_t hashName(const char *name) {
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for (const char *c = name; *c; c++) {
+		hash ^= static_cast<unsigned char>(*c);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+LogThroughput::LoggerSlot *LogThroughput::findLogger(const char *name) {
+	const uint32_t hash = hashName(name);
+	// The last slot is the overflow bucket, never claimed by name
+	for (size_t i = 0; i < kMaxLoggers - 1; i++) {
+		LoggerSlot &slot = m_loggers[i];
+		uint32_t state = slot.state.load(std::memory_order_acquire);
+		if (state == LoggerSlot::Free) {
+			if (slot.state.compare_exchange_strong(
+					state, LoggerSlot::Claiming, std::memory_order_acquire)) {
+				slot.hash = hash;
+				std::strncpy(slot.name, name, sizeof(slot.name) - 1);
+				slot.state.store(LoggerSlot::Ready, std::memory_order_release);
+				return &slot;
+			}
+		}
+		// Another thread is publishing this slot's name; it only takes a
+		// few instructions
+		while (state == LoggerSlot::Claiming)
+			state = slot.state.load(std::memory_order_acquire);
+		if (slot.hash == hash &&
+			std::strncmp(slot.name, name, sizeof(slot.name) - 1) == 0)
+			return &slot;
+	}
+	LoggerSlot &other = m_loggers[kMaxLoggers - 1];
+	uint32_t state = LoggerSlot::Free;
+	if (other.state.compare_exchange_strong(state, LoggerSlot::Claiming,
+											std::memory_order_acquire)) {
+		std::strncpy(other.name, "(other)", sizeof(other.name) - 1);
+		other.state.store(LoggerSlot::Ready, std::memory_order_release);
+	}
+	return &other;
+}
+
+void LogThroughput::count(LogLevel level, const char *loggerName) {
+	m_levels[static_cast<size_t>(level) % kLevelCount].total.fetch_add(
+		1, std::memory_order_relaxed);
+	m_total.total.fetch_add(1, std::memory_order_relaxed);
+	findLogger(loggerName ? loggerName : "")
+		->counter.total.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool LogThroughput::sample(std::chrono::steady_clock::time_point now) {
+	if (!m_started) {
+		m_lastSample = now;
+		m_started = true;
+		return false;
+	}
+	float seconds = std::chrono::duration<float>(now - m_lastSample).count();
+	if (seconds < 1.0f)
+		return false;
+	m_lastSample = now;
+
+	auto rate = [seconds](Counter &counter) {
+		uint64_t total = counter.total.load(std::memory_order_relaxed);
+		float value = static_cast<float>(total - counter.sampledTotal) / seconds;
+		counter.sampledTotal = total;
+		return value;
+	};
+	for (size_t i = 0; i < kLevelCount; i++)
+		push(m_levelRates[i], rate(m_levels[i]));
+	push(m_totalRates, rate(m_total));
+	for (LoggerSlot &slot : m_loggers) {
+		if (slot.state.load(std::memory_order_acquire) == LoggerSlot::Ready)
+			push(slot.rates, rate(slot.counter));
+	}
+	return true;
+}
+
+void LogThroughput::push(Ring &ring, float value) {
+	uint64_t head = ring.head.load(std::memory_order_relaxed);
+	ring.samples[head % kHistory].store(value, std::memory_order_relaxed);
+	ring.head.store(head + 1, std::memory_order_release);
+}
+
+float LogThroughput::latest(const Ring &ring) {
+	uint64_t head = ring.head.load(std::memory_order_acquire);
+	return head > 0 ? ring.samples[(head - 1) % kHistory].load(
+						  std::memory_order_relaxed)
+					: 0.0f;
+}
+
+size_t LogThroughput::copy(const Ring &ring, float *out, size_t maxSamples) {
+	uint64_t head = ring.head.load(std::memory_order_acquire);
+	size_t count = static_cast<size_t>(std::min<uint64_t>(head, kHistory));
+	count = std::min(count, maxSamples);
+	for (size_t i = 0; i < count; i++) {
+		out[i] = ring.samples[(head - count + i) % kHistory].load(
+			std::memory_order_relaxed);
+	}
+	return count;
+}
+
+float LogThroughput::getRate(LogLevel level) const {
+	return latest(m_levelRates[static_cast<size_t>(level) % kLevelCount]);
+}
+
+uint64_t LogThroughput::getTotal(LogLevel level) const {
+	return m_levels[static_cast<size_t>(level) % kLevelCount].total.load(
+		std::memory_order_relaxed);
+}
+
+size_t LogThroughput::copyRates(LogLevel level, float *out,
+								size_t maxSamples) const {
+	return copy(m_levelRates[static_cast<size_t>(level) % kLevelCount], out,
+				maxSamples);
+}
+
+size_t LogThroughput::getLoggerCount() const {
+	size_t count = 0;
+	while (count < kMaxLoggers - 1 &&
+		   m_loggers[count].state.load(std::memory_order_acquire) ==
+			   LoggerSlot::Ready)
+		count++;
+	// The overflow slot only shows up once used
+	if (m_loggers[kMaxLoggers - 1].state.load(std::memory_order_acquire) ==
+		LoggerSlot::Ready)
+		return kMaxLoggers;
+	return count;
+}
+
+const char *LogThroughput::getLoggerName(size_t index) const {
+	if (index >= kMaxLoggers ||
+		m_loggers[index].state.load(std::memory_order_acquire) !=
+			LoggerSlot::Ready)
+		return "";
+	return m_loggers[index].name;
+}
+
+float LogThroughput::getLoggerRate(size_t index) const {
+	return index < kMaxLoggers ? latest(m_loggers[index].rates) : 0.0f;
+}
+
+size_t LogThroughput::copyLoggerRates(size_t index, float *out,
+									  size_t maxSamples) const {
+	return index < kMaxLoggers ? copy(m_loggers[index].rates, out, maxSamples)
+							   : 0;
+}
+
+} // namespace blot
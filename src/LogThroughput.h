@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "LogStore.h"
+
+namespace blot {
+
+// Log line counters per level and per logger. count() is lock-free and may
+// be called from any logging thread; sample() runs on the UI thread and,
+// once per second, appends the lines/second of the elapsed interval to a
+// fixed-size ring per counter. Like FrameProfiler, each ring has a single
+// writer that publishes with a release store of its head, so any thread can
+// read rates without locking.
+class LogThroughput {
+  public:
+	static constexpr size_t kHistory = 120;	 // seconds kept per ring
+	static constexpr size_t kMaxLoggers = 32; // later loggers share "other"
+	static constexpr size_t kLevelCount = 4;
+
+	// Any thread
+	void count(LogLevel level, const char *loggerName);
+
+	// UI thread; returns true when a new sample was taken
+	bool sample(std::chrono::steady_clock::time_point now =
+					std::chrono::steady_clock::now());
+
+	// Lines/second of the last completed interval
+	float getRate(LogLevel level) const;
+	float getTotalRate() const { return latest(m_totalRates); }
+	// Lines counted since startup
+	uint64_t getTotal(LogLevel level) const;
+
+	// Copies up to maxSamples rates (oldest first)
+	size_t copyRates(LogLevel level, float *out, size_t maxSamples) const;
+	size_t copyTotalRates(float *out, size_t maxSamples) const {
+		return copy(m_totalRates, out, maxSamples);
+	}
+
+	// Loggers seen so far, in order of first appearance. The last slot
+	// collects every logger beyond kMaxLoggers - 1 and is named "(other)".
+	size_t getLoggerCount() const;
+	const char *getLoggerName(size_t index) const;
+	float getLoggerRate(size_t index) const;
+	size_t copyLoggerRates(size_t index, float *out, size_t maxSamples) const;
+
+  private:
+	struct Ring {
+		std::atomic<uint64_t> head{0};
+		std::array<std::atomic<float>, kHistory> samples{};
+	};
+	struct Counter {
+		std::atomic<uint64_t> total{0};
+		uint64_t sampledTotal = 0; // UI thread
+	};
+	struct LoggerSlot {
+		enum State : uint32_t { Free, Claiming, Ready };
+		std::atomic<uint32_t> state{Free};
+		uint32_t hash = 0;
+		char name[32] = {};
+		Counter counter;
+		Ring rates;
+	};
+
+	static void push(Ring &ring, float value);
+	static float latest(const Ring &ring);
+	static size_t copy(const Ring &ring, float *out, size_t maxSamples);
+	LoggerSlot *findLogger(const char *name);
+
+	std::array<Counter, kLevelCount> m_levels;
+	std::array<Ring, kLevelCount> m_levelRates;
+	Counter m_total;
+	Ring m_totalRates;
+	std::array<LoggerSlot, kMaxLoggers> m_loggers;
+	std::chrono::steady_clock::time_point m_lastSample;
+	bool m_started = false;
+};
+
+} // namespace blot
@@ -1,17 +1,26 @@
 #include "LogWindow.h"
-#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <imgui.h>
-#include <iomanip>
-#include <iostream>
 #include <memory>
+#include <spdlog/details/null_mutex.h>
 #include <spdlog/sinks/base_sink.h>
 #include <spdlog/spdlog.h>
-#include <sstream>
+#include "GlyphLoader.h"
+#ifdef BXIMGUI_HAS_IMPLOT
+#include <implot.h>
+#endif
 
 namespace blot {
 
-// Custom spdlog sink that forwards messages to LogWindow
-class LogWindowSink : public spdlog::sinks::base_sink<std::mutex> {
+// Custom spdlog sink that forwards messages to LogWindow. sink_it_ only
+// pushes into LogWindow's lock-free queue, so no mutex is needed and logging
+// threads never wait on the UI.
+class LogWindowSink
+	: public spdlog::sinks::base_sink<spdlog::details::null_mutex> {
   public:
 	LogWindowSink(LogWindow *logWindow) : m_logWindow(logWindow) {}
 
@@ -38,9 +47,17 @@ class LogWindowSink : public spdlog::sinks::base_sink<std::mutex> {
 			level = LogLevel::Info;
 			break;
 		}
-		std::string message(msg.payload.begin(), msg.payload.end());
-		std::string timestamp = m_logWindow->getCurrentTimestamp();
-		m_logWindow->addLogFromSink(level, message, timestamp);
+		PendingLogEntry entry;
+		entry.level = level;
+		entry.message.assign(msg.payload.begin(), msg.payload.end());
+		entry.time = msg.time;
+		entry.threadId = msg.thread_id;
+		entry.sourceFile = msg.source.filename;
+		entry.sourceLine = msg.source.line;
+		size_t nameLength = (std::min)(msg.logger_name.size(),
+									   sizeof(entry.loggerName) - 1);
+		std::memcpy(entry.loggerName, msg.logger_name.data(), nameLength);
+		m_logWindow->addLogFromSink(std::move(entry));
 	}
 	void flush_() override {}
 
@@ -65,19 +82,67 @@ void LogWindow::setupSpdlogSink() {
 	}
 }
 
-void LogWindow::addLogFromSink(LogLevel level, const std::string &message,
-							   const std::string &timestamp) {
-	std::lock_guard<std::mutex> lock(m_logMutex);
-	m_logEntries.emplace_back(level, message, timestamp);
-	if (m_logEntries.size() > m_maxLogLines) {
-		m_logEntries.erase(m_logEntries.begin());
+void LogWindow::addLogFromSink(PendingLogEntry &&entry) {
+	m_throughput.count(entry.level, entry.loggerName);
+	if (!m_pendingLogs.tryPush(std::move(entry))) {
+		// Never block the logging thread; the UI shows the drop count
+		m_droppedLogs.fetch_add(1, std::memory_order_relaxed);
+		return;
 	}
-	m_scrollToBottom = true;
+	requestRedraw();
+	// update() re-arms this once it has drained the queue
+	if (m_wakeCallback &&
+		!m_wakePosted.exchange(true, std::memory_order_acq_rel))
+		m_wakeCallback();
+}
+
+void LogWindow::update() {
+	m_throughput.sample();
+	// Re-armed before draining: a line pushed after this wakes again
+	m_wakePosted.store(false, std::memory_order_release);
+	bool received = false;
+	while (m_pendingLogs.tryPop(m_drainScratch)) {
+		// Scripts the atlas was not baked with load while the line waits
+		requestGlyphs(m_drainScratch.message.data(),
+					  m_drainScratch.message.data() +
+						  m_drainScratch.message.size());
+		m_store.append(m_drainScratch);
+		received = true;
+	}
+	if (received && m_autoScroll) {
+		// Following the tail: history paged in from disk is let go again
+		m_scrollToBottom = true;
+		m_pagedBeginSeq = kNoSeq;
+	}
+}
+
+void LogWindow::setSpillDirectory(const std::string &directory,
+								  uint64_t maxBytes) {
+	m_store.setSpill(directory, maxBytes);
+	m_pagedBeginSeq = kNoSeq;
+	m_pageAnchorSeq = kNoSeq;
+	m_indexValid = false;
+}
+
+uint64_t LogWindow::viewBeginSeq() const {
+	if (m_pagedBeginSeq < m_store.beginSeq())
+		return (std::max)(m_pagedBeginSeq, m_store.historyBeginSeq());
+	return m_store.beginSeq();
+}
+
+void LogWindow::setRateLimit(double linesPerSecond, double burst) {
+	// Default burst: one second's worth of lines
+	m_store.setRateLimit(linesPerSecond,
+						 burst > 0.0 ? burst : linesPerSecond);
+	m_rateLimitInput = static_cast<int>(m_store.getRateLimit());
 }
 
 void LogWindow::clearLog() {
-	std::lock_guard<std::mutex> lock(m_logMutex);
-	m_logEntries.clear();
+	m_store.clear();
+	m_pagedBeginSeq = kNoSeq;
+	m_pageAnchorSeq = kNoSeq;
+	// Rebuilt (and any search restarted) on the next frame
+	m_indexValid = false;
 	// Optionally, log this event via spdlog
 	spdlog::info("Log cleared.");
 }
@@ -85,12 +150,40 @@ void LogWindow::clearLog() {
 void LogWindow::renderContents() {
 	renderMenuBar();
 	renderFilterControls();
+	if (m_showThroughput)
+		renderThroughputStrip();
+	renderSearchControls();
 	renderLogEntries();
 }
 
 void LogWindow::renderMenuBar() {
 	if (ImGui::BeginMenuBar()) {
 		ImGui::Checkbox("Show Timestamps", &m_showTimestamps);
+		ImGui::Checkbox("Rates", &m_showThroughput);
+		bool coalesce = m_store.isCoalescing();
+		if (ImGui::Checkbox("Coalesce Repeats", &coalesce))
+			m_store.setCoalescing(coalesce);
+		ImGui::SetNextItemWidth(80.0f);
+		if (ImGui::InputInt("Lines/s", &m_rateLimitInput, 0, 0,
+							ImGuiInputTextFlags_EnterReturnsTrue)) {
+			setRateLimit((std::max)(m_rateLimitInput, 0));
+		}
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip("Per-logger rate limit (0 = unlimited)");
+		if (const LogSpill *spill = m_store.getSpill()) {
+			std::string error = spill->getError();
+			ImGui::TextColored(
+				getLogColor(error.empty() ? LogLevel::Debug : LogLevel::Error),
+				"Disk: %.1f MB",
+				static_cast<double>(spill->getDiskUsage()) / (1024.0 * 1024.0));
+			if (ImGui::IsItemHovered()) {
+				ImGui::SetTooltip("%zu segments in %s%s%s",
+								  spill->getSegmentCount(),
+								  spill->getDirectory().c_str(),
+								  error.empty() ? "" : "\n",
+								  error.c_str());
+			}
+		}
 		ImGui::EndMenuBar();
 	}
 }
@@ -109,44 +202,375 @@ void LogWindow::renderFilterControls() {
 	if (ImGui::Button("Clear")) {
 		clearLog();
 	}
+	uint64_t dropped = getDroppedLogCount();
+	if (dropped > 0) {
+		ImGui::SameLine();
+		ImGui::TextColored(getLogColor(LogLevel::Warning), "Dropped: %llu",
+						   static_cast<unsigned long long>(dropped));
+	}
+	uint64_t limited = m_store.getRateLimitedCount();
+	if (limited > 0) {
+		ImGui::SameLine();
+		ImGui::TextColored(getLogColor(LogLevel::Warning),
+						   "Rate limited: %llu",
+						   static_cast<unsigned long long>(limited));
+		if (ImGui::IsItemHovered()) {
+			ImGui::BeginTooltip();
+			for (size_t i = 0; i < m_store.loggerCount(); i++) {
+				auto id = static_cast<uint16_t>(i);
+				uint64_t count = m_store.getRateLimitedCount(id);
+				if (count > 0)
+					ImGui::Text("%s: %llu", facetLabel(0, id),
+								static_cast<unsigned long long>(count));
+			}
+			ImGui::EndTooltip();
+		}
+	}
+}
+
+void LogWindow::renderSparkline(const char *id, const float *values,
+								size_t count, const ImVec4 &color) {
+	const ImVec2 size(90.0f, ImGui::GetFrameHeight());
+	float maxValue = 1.0f;
+	for (size_t i = 0; i < count; i++)
+		maxValue = (std::max)(maxValue, values[i]);
+#ifdef BXIMGUI_HAS_IMPLOT
+	if (ImPlot::GetCurrentContext()) {
+		ImPlot::PushStyleVar(ImPlotStyleVar_PlotPadding, ImVec2(0, 0));
+		if (ImPlot::BeginPlot(id, size,
+							  ImPlotFlags_CanvasOnly | ImPlotFlags_NoChild)) {
+			ImPlot::SetupAxes(nullptr, nullptr, ImPlotAxisFlags_NoDecorations,
+							  ImPlotAxisFlags_NoDecorations);
+			ImPlot::SetupAxesLimits(0, LogThroughput::kHistory - 1, 0,
+									maxValue * 1.1, ImGuiCond_Always);
+			ImPlot::SetNextLineStyle(color);
+			ImPlot::SetNextFillStyle(color, 0.25f);
+			// Right-aligned so the newest second is always at the edge
+			ImPlot::PlotLine(id, values, static_cast<int>(count), 1.0,
+							 static_cast<double>(LogThroughput::kHistory -
+												 count),
+							 ImPlotLineFlags_Shaded);
+			ImPlot::EndPlot();
+		}
+		ImPlot::PopStyleVar();
+		return;
+	}
+#endif
+	ImGui::PushStyleColor(ImGuiCol_PlotLines, color);
+	ImGui::PlotLines(id, values, static_cast<int>(count), 0, nullptr, 0.0f,
+					 maxValue * 1.1f, size);
+	ImGui::PopStyleColor();
+}
+
+void LogWindow::renderThroughputStrip() {
+	ImGui::PushID("Throughput");
+	for (LogLevel level : {LogLevel::Debug, LogLevel::Info, LogLevel::Warning,
+						   LogLevel::Error}) {
+		size_t count = m_throughput.copyRates(level, m_rateSamples.data(),
+											  m_rateSamples.size());
+		ImGui::PushID(static_cast<int>(level));
+		renderSparkline("##Rate", m_rateSamples.data(), count,
+						getLogColor(level));
+		ImGui::PopID();
+		ImGui::SameLine();
+		ImGui::TextColored(getLogColor(level), "%s %.0f/s",
+						   getLogLevelString(level),
+						   m_throughput.getRate(level));
+		ImGui::SameLine();
+	}
+	ImGui::Text("Total %.0f/s", m_throughput.getTotalRate());
+	if (ImGui::IsItemHovered()) {
+		ImGui::BeginTooltip();
+		for (size_t i = 0; i < m_throughput.getLoggerCount(); i++) {
+			const char *name = m_throughput.getLoggerName(i);
+			ImGui::Text("%s: %.0f/s", *name ? name : "(default)",
+						m_throughput.getLoggerRate(i));
+		}
+		ImGui::EndTooltip();
+	}
+	ImGui::PopID();
+}
+
+void LogWindow::renderSearchControls() {
+	ImGui::SetNextItemWidth(220.0f);
+	ImGui::InputTextWithHint("##LogSearch", "Search...", m_searchBuffer,
+							 sizeof(m_searchBuffer));
+	ImGui::SameLine();
+	ImGui::Checkbox("Regex", &m_searchRegex);
+	ImGui::SameLine();
+	ImGui::Checkbox("Aa", &m_searchCaseSensitive);
+	if (ImGui::IsItemHovered())
+		ImGui::SetTooltip("Case sensitive");
+
+	renderFacetCombo("Logger", m_loggerFilter, m_store.loggerCount(), 0);
+	ImGui::SameLine();
+	renderFacetCombo("Thread", m_threadFilter, m_store.threadCount(), 1);
+	ImGui::SameLine();
+	renderFacetCombo("Source", m_sourceFilter, m_store.sourceCount(), 2);
+
+	if (!m_indexQuery.isActive())
+		return;
+	ImGui::SameLine();
+	if (m_search.isRunning()) {
+		ImGui::ProgressBar(m_search.getProgress(), ImVec2(120.0f, 0.0f));
+		ImGui::SameLine();
+	}
+	std::string error = m_search.getError();
+	if (!error.empty()) {
+		ImGui::TextColored(getLogColor(LogLevel::Error), "%s", error.c_str());
+	} else {
+		ImGui::Text("%zu matches", m_filtered.size() - m_filteredStart);
+	}
+}
+
+const char *LogWindow::facetLabel(int kind, int id) {
+	if (id < 0)
+		return "All";
+	auto facetId = static_cast<uint16_t>(id);
+	if (kind == 0) {
+		const std::string &name = m_store.loggerName(facetId);
+		return name.empty() ? "(default)" : name.c_str();
+	}
+	if (kind == 1) {
+		snprintf(m_labelBuffer, sizeof(m_labelBuffer), "%zu",
+				 m_store.threadId(facetId));
+		return m_labelBuffer;
+	}
+	LogStore::SourceLocation source = m_store.sourceLocation(facetId);
+	if (!source.file)
+		return "(none)";
+	const char *file = source.file;
+	for (const char *c = source.file; *c; c++) {
+		if (*c == '/' || *c == '\\')
+			file = c + 1;
+	}
+	snprintf(m_labelBuffer, sizeof(m_labelBuffer), "%s:%d", file, source.line);
+	return m_labelBuffer;
+}
+
+bool LogWindow::renderFacetCombo(const char *label, int &selection,
+								 size_t count, int kind) {
+	bool changed = false;
+	ImGui::SetNextItemWidth(140.0f);
+	if (ImGui::BeginCombo(label, facetLabel(kind, selection))) {
+		if (ImGui::Selectable("All", selection < 0)) {
+			selection = -1;
+			changed = true;
+		}
+		for (size_t i = 0; i < count; i++) {
+			int id = static_cast<int>(i);
+			ImGui::PushID(id);
+			if (ImGui::Selectable(facetLabel(kind, id), selection == id)) {
+				selection = id;
+				changed = true;
+			}
+			ImGui::PopID();
+		}
+		ImGui::EndCombo();
+	}
+	return changed;
+}
+
+int LogWindow::filterMask() const {
+	return (m_showDebug ? 1 : 0) | (m_showInfo ? 2 : 0) |
+		   (m_showWarning ? 4 : 0) | (m_showError ? 8 : 0);
+}
+
+bool LogWindow::filtersChanged() const {
+	// Compared field by field so an unchanged frame builds no strings
+	const LogSearch::Query &q = m_indexQuery;
+	return !m_indexValid || q.levelMask != filterMask() ||
+		   q.text != m_searchBuffer || q.regex != m_searchRegex ||
+		   q.caseSensitive != m_searchCaseSensitive ||
+		   q.loggerId != m_loggerFilter || q.threadId != m_threadFilter ||
+		   q.sourceId != m_sourceFilter;
+}
+
+LogSearch::Query LogWindow::buildQuery() const {
+	LogSearch::Query query;
+	query.text = m_searchBuffer;
+	query.regex = m_searchRegex;
+	query.caseSensitive = m_searchCaseSensitive;
+	query.levelMask = filterMask();
+	query.loggerId = m_loggerFilter;
+	query.threadId = m_threadFilter;
+	query.sourceId = m_sourceFilter;
+	return query;
+}
+
+uint32_t LogWindow::measureLines(uint64_t seq, float wrapWidth) {
+	uint32_t index = 0;
+	LogChunk &chunk = m_store.chunkFor(seq, index);
+	uint16_t &lineCount = chunk.lineCounts(wrapWidth)[index];
+	if (lineCount == 0) {
+		const LogRecord &record = chunk.record(index);
+		const char *text = chunk.text(record);
+		ImVec2 size = ImGui::CalcTextSize(text, text + record.textLength,
+										  false, wrapWidth);
+		float lines = size.y / ImGui::GetTextLineHeight() + 0.5f;
+		lineCount = static_cast<uint16_t>(
+			(std::min)((std::max)(lines, 1.0f), 65535.0f));
+	}
+	return lineCount;
+}
+
+void LogWindow::resetIndex() {
+	m_filtered.clear();
+	m_lineStarts.clear();
+	m_filteredStart = 0;
+	m_indexedSeq = viewBeginSeq();
+	m_indexEndLine = 0;
+}
+
+void LogWindow::relayoutIndex(float wrapWidth) {
+	// Same entries, new wrap width: only the line offsets change
+	m_indexEndLine = 0;
+	for (size_t i = m_filteredStart; i < m_filtered.size(); i++) {
+		m_lineStarts[i] = m_indexEndLine;
+		m_indexEndLine += measureLines(m_filtered[i], wrapWidth);
+	}
+}
+
+void LogWindow::appendToIndex(uint64_t seq, float wrapWidth) {
+	m_filtered.push_back(seq);
+	m_lineStarts.push_back(m_indexEndLine);
+	m_indexEndLine += measureLines(seq, wrapWidth);
+}
+
+void LogWindow::updateFilteredIndex(float wrapWidth) {
+	const uint64_t firstSeq = viewBeginSeq();
+	const uint64_t endSeq = m_store.endSeq();
+	if (filtersChanged()) {
+		resetIndex();
+		m_indexQuery = buildQuery();
+		m_indexValid = true;
+		m_indexWrapWidth = wrapWidth;
+		if (m_indexQuery.isActive()) {
+			m_search.start(m_indexQuery, m_store.chunksFrom(firstSeq),
+						   firstSeq, endSeq);
+			m_searchedSeq = endSeq;
+		} else {
+			m_search.cancel();
+		}
+	}
+
+	// Forget entries that left the view (evicted, or rotated off disk)
+	while (m_filteredStart < m_filtered.size() &&
+		   m_filtered[m_filteredStart] < firstSeq) {
+		++m_filteredStart;
+	}
+	if (m_filteredStart > 4096 && m_filteredStart * 2 > m_filtered.size()) {
+		m_filtered.erase(m_filtered.begin(),
+						 m_filtered.begin() + m_filteredStart);
+		m_lineStarts.erase(m_lineStarts.begin(),
+						   m_lineStarts.begin() + m_filteredStart);
+		m_filteredStart = 0;
+	}
+
+	if (wrapWidth != m_indexWrapWidth) {
+		relayoutIndex(wrapWidth);
+		m_indexWrapWidth = wrapWidth;
+	}
+
+	if (m_indexQuery.isActive()) {
+		// Hand new lines to the search and collect what it found so far
+		if (endSeq > m_searchedSeq) {
+			m_search.extend(m_store.chunksFrom(m_searchedSeq), m_searchedSeq,
+							endSeq);
+			m_searchedSeq = endSeq;
+		}
+		m_searchResults.clear();
+		m_search.takeResults(m_searchResults);
+		for (uint64_t seq : m_searchResults) {
+			if (seq >= firstSeq)
+				appendToIndex(seq, wrapWidth);
+		}
+		return;
+	}
+
+	// Level filters only: index entries that arrived since the last frame
+	const int mask = m_indexQuery.levelMask;
+	m_indexedSeq = (std::max)(m_indexedSeq, firstSeq);
+	for (; m_indexedSeq < endSeq; ++m_indexedSeq) {
+		int level = static_cast<int>(m_store.record(m_indexedSeq).level);
+		if (mask & (1 << level))
+			appendToIndex(m_indexedSeq, wrapWidth);
+	}
 }
 
 void LogWindow::renderLogEntries() {
 	// Set black background for log text area only
 	ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0, 0, 0, 1));
 	ImGui::BeginChild("LogEntries", ImVec2(0, 0), true);
-	std::lock_guard<std::mutex> lock(m_logMutex);
-	for (const auto &entry : m_logEntries) {
-		bool shouldShow = false;
-		switch (entry.level) {
-		case LogLevel::Debug:
-			shouldShow = m_showDebug;
-			break;
-		case LogLevel::Info:
-			shouldShow = m_showInfo;
-			break;
-		case LogLevel::Warning:
-			shouldShow = m_showWarning;
-			break;
-		case LogLevel::Error:
-			shouldShow = m_showError;
-			break;
-		}
-		if (!shouldShow)
-			continue;
-		ImGui::PushStyleColor(ImGuiCol_Text, getLogColor(entry.level));
-		std::string header;
-		if (m_showTimestamps) {
-			header = "[" + entry.timestamp + "] [" +
-					 getLogLevelString(entry.level) + "] ";
-		} else {
-			header = "[" + getLogLevelString(entry.level) + "] ";
+
+	// Headers have a fixed width; messages wrap in the column to their right
+	float headerWidth = 0.0f;
+	for (LogLevel level : {LogLevel::Debug, LogLevel::Info, LogLevel::Warning,
+						   LogLevel::Error}) {
+		headerWidth = (std::max)(
+			headerWidth, ImGui::CalcTextSize(getLogLevelString(level)).x);
+	}
+	headerWidth +=
+		ImGui::CalcTextSize(m_showTimestamps ? "[00:00:00.000] [] " : "[] ")
+			.x;
+	// Room for the repeat badge of coalesced lines
+	const float badgeX = headerWidth;
+	if (m_store.isCoalescing())
+		headerWidth += ImGui::CalcTextSize("x99999+ ").x;
+	const float wrapWidth = std::floor(
+		(std::max)(ImGui::GetContentRegionAvail().x - headerWidth, 1.0f));
+	updateFilteredIndex(wrapWidth);
+
+	const uint64_t firstLine = m_filteredStart < m_filtered.size()
+								   ? m_lineStarts[m_filteredStart]
+								   : m_indexEndLine;
+	const float lineHeight = ImGui::GetTextLineHeight();
+	const float x0 = ImGui::GetCursorScreenPos().x;
+
+	// The clipper works in wrapped lines; entries are packed with no spacing
+	// so an entry of N lines is exactly N * lineHeight tall
+	ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
+	ImGuiListClipper clipper;
+	clipper.Begin(static_cast<int>(m_indexEndLine - firstLine), lineHeight);
+	while (clipper.Step()) {
+		const uint64_t displayStart = firstLine + clipper.DisplayStart;
+		const uint64_t displayEnd = firstLine + clipper.DisplayEnd;
+		// Entry holding the first visible line
+		auto first = std::upper_bound(m_lineStarts.begin() + m_filteredStart,
+									  m_lineStarts.end(), displayStart);
+		size_t i = static_cast<size_t>(first - m_lineStarts.begin()) - 1;
+		for (; i < m_filtered.size() && m_lineStarts[i] < displayEnd; i++) {
+			uint32_t index = 0;
+			const LogChunk &chunk = m_store.chunkFor(m_filtered[i], index);
+			const LogRecord &record = chunk.record(index);
+			const char *text = chunk.text(record);
+			float y = clipper.StartPosY +
+					  static_cast<float>(m_lineStarts[i] - firstLine) *
+						  lineHeight;
+			ImGui::PushStyleColor(ImGuiCol_Text, getLogColor(record.level));
+			ImGui::SetCursorScreenPos(ImVec2(x0, y));
+			if (m_showTimestamps) {
+				ImGui::Text("[%s] [%s] ", formatTimestamp(record.timeNs),
+							getLogLevelString(record.level));
+			} else {
+				ImGui::Text("[%s] ", getLogLevelString(record.level));
+			}
+			if (const LogRepeat *repeat = chunk.repeat(index)) {
+				ImGui::SetCursorScreenPos(ImVec2(x0 + badgeX, y));
+				renderRepeatBadge(*repeat, record);
+			}
+			ImGui::SetCursorScreenPos(ImVec2(x0 + headerWidth, y));
+			ImGui::PushTextWrapPos(0.0f);
+			ImGui::TextUnformatted(text, text + record.textLength);
+			ImGui::PopTextWrapPos();
+			ImGui::PopStyleColor();
 		}
-		ImGui::TextUnformatted(header.c_str());
-		ImGui::SameLine();
-		ImGui::TextWrapped("%s", entry.message.c_str());
-		ImGui::PopStyleColor();
 	}
+	ImGui::PopStyleVar();
+
+	pageOlderHistory(firstLine, lineHeight);
+	m_autoScroll = m_scrollToBottom ||
+				   ImGui::GetScrollY() >= ImGui::GetScrollMaxY() - 1.0f;
 	if (m_scrollToBottom) {
 		ImGui::SetScrollHereY(1.0f);
 		m_scrollToBottom = false;
@@ -155,6 +579,57 @@ void LogWindow::renderLogEntries() {
 	ImGui::PopStyleColor();
 }
 
+void LogWindow::pageOlderHistory(uint64_t firstLine, float lineHeight) {
+	if (m_pageAnchorSeq != kNoSeq) {
+		// Wait for a running search to cover the paged-in segment
+		if (m_indexQuery.isActive() && m_search.isRunning())
+			return;
+		auto anchor = std::lower_bound(m_filtered.begin() + m_filteredStart,
+									   m_filtered.end(), m_pageAnchorSeq);
+		if (anchor != m_filtered.end()) {
+			uint64_t lines = m_lineStarts[anchor - m_filtered.begin()] -
+							 firstLine;
+			ImGui::SetScrollY(ImGui::GetScrollY() +
+							  static_cast<float>(lines) * lineHeight);
+		}
+		m_pageAnchorSeq = kNoSeq;
+		return;
+	}
+
+	// At the top and scrolling further up (or with a scrollbar to return
+	// with): bring in the segment before the first viewed line
+	const bool atTop = ImGui::GetScrollY() <= 0.0f;
+	const bool wantsOlder = ImGui::GetScrollMaxY() > 0.0f ||
+							(ImGui::IsWindowHovered() &&
+							 ImGui::GetIO().MouseWheel > 0.0f);
+	const uint64_t viewBegin = viewBeginSeq();
+	if (!atTop || !wantsOlder || m_scrollToBottom ||
+		viewBegin <= m_store.historyBeginSeq())
+		return;
+	uint32_t index = 0;
+	m_pagedBeginSeq = m_store.chunkFor(viewBegin - 1, index).firstSeq();
+	m_pageAnchorSeq = viewBegin;
+	// Lines can only be appended to the index, so rebuild it
+	m_indexValid = false;
+}
+
+void LogWindow::renderRepeatBadge(const LogRepeat &repeat,
+								  const LogRecord &record) {
+	if (repeat.count > 99999) {
+		ImGui::TextUnformatted("x99999+");
+	} else {
+		ImGui::Text("x%u", repeat.count);
+	}
+	if (ImGui::IsItemHovered()) {
+		ImGui::BeginTooltip();
+		// formatTimestamp reuses its buffer, so print one at a time
+		ImGui::Text("Repeated %u times", repeat.count);
+		ImGui::Text("First: %s", formatTimestamp(record.timeNs));
+		ImGui::Text("Last:  %s", formatTimestamp(repeat.lastTimeNs));
+		ImGui::EndTooltip();
+	}
+}
+
 ImVec4 LogWindow::getLogColor(LogLevel level) {
 	switch (level) {
 	case LogLevel::Debug:
@@ -170,7 +645,7 @@ ImVec4 LogWindow::getLogColor(LogLevel level) {
 	}
 }
 
-std::string LogWindow::getLogLevelString(LogLevel level) {
+const char *LogWindow::getLogLevelString(LogLevel level) {
 	switch (level) {
 	case LogLevel::Debug:
 		return "DEBUG";
@@ -185,16 +660,21 @@ std::string LogWindow::getLogLevelString(LogLevel level) {
 	}
 }
 
-std::string LogWindow::getCurrentTimestamp() {
-	auto now = std::chrono::system_clock::now();
-	auto time_t = std::chrono::system_clock::to_time_t(now);
-	auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-				  now.time_since_epoch()) %
-			  1000;
-	std::stringstream ss;
-	ss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
-	ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-	return ss.str();
+const char *LogWindow::formatTimestamp(int64_t timeNs) {
+	const int64_t second = timeNs / 1000000000;
+	const int millis = static_cast<int>((timeNs / 1000000) % 1000);
+	TimestampPrefix &prefix =
+		m_timestampPrefixes[static_cast<size_t>(second) %
+							m_timestampPrefixes.size()];
+	if (prefix.second != second) {
+		std::time_t time = static_cast<std::time_t>(second);
+		std::tm local = *std::localtime(&time);
+		std::strftime(prefix.text, sizeof(prefix.text), "%H:%M:%S", &local);
+		prefix.second = second;
+	}
+	snprintf(m_timestampBuffer, sizeof(m_timestampBuffer), "%s.%03d",
+			 prefix.text, millis);
+	return m_timestampBuffer;
 }
 
 } // namespace blot
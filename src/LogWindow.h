@@ -1,10 +1,18 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <imgui.h>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <vector>
+#include "LogSearch.h"
+#include "LogSpill.h"
+#include "LogStore.h"
+#include "LogThroughput.h"
+#include "MpscQueue.h"
 #include "Window.h"
 namespace spdlog {
 class logger;
@@ -15,16 +23,6 @@ class sink;
 
 namespace blot {
 
-enum class LogLevel { Debug, Info, Warning, Error };
-
-struct LogEntry {
-	LogLevel level;
-	std::string message;
-	std::string timestamp;
-	LogEntry(LogLevel lvl, const std::string &msg, const std::string &time = "")
-		: level(lvl), message(msg), timestamp(time) {}
-};
-
 class LogWindow : public Window {
   public:
 	LogWindow(const std::string &title = "Log###Log",
@@ -43,6 +41,50 @@ class LogWindow : public Window {
 	// For UI: clear log buffer
 	void clearLog();
 
+	// In-memory retention cap; older chunks are spilled (see below) or,
+	// without a spill directory, dropped
+	void setMaxLogLines(size_t maxLines) { m_store.setMaxRecords(maxLines); }
+	size_t getMaxLogLines() const { return m_store.getMaxRecords(); }
+
+	// Spill lines evicted from memory to segment files in directory, capped
+	// at maxBytes on disk; scrolling above the in-memory history pages them
+	// back in. An empty directory disables spilling.
+	void setSpillDirectory(const std::string &directory,
+						   uint64_t maxBytes = LogSpill::kDefaultMaxBytes);
+
+	// Called from the logging thread when lines arrive, at most once
+	// between two update() calls, so a log storm wakes the UI once per frame
+	void setWakeCallback(std::function<void()> callback) {
+		m_wakeCallback = std::move(callback);
+	}
+
+	// Messages dropped because the ingestion queue was full
+	uint64_t getDroppedLogCount() const {
+		return m_droppedLogs.load(std::memory_order_relaxed);
+	}
+
+	// Identical lines arriving close together are shown once with a repeat
+	// count
+	void setCoalesceRepeats(bool enabled) { m_store.setCoalescing(enabled); }
+	bool isCoalescingRepeats() const { return m_store.isCoalescing(); }
+
+	// Per-logger rate limit in lines per second (0 = unlimited); lines over
+	// the limit are counted per logger and dropped
+	void setRateLimit(double linesPerSecond, double burst = 0.0);
+	double getRateLimit() const { return m_store.getRateLimit(); }
+	uint64_t getRateLimitedCount() const {
+		return m_store.getRateLimitedCount();
+	}
+
+	// Lines/second per level and per logger, counted as lines reach the sink
+	// (before queueing, so drops are included) and sampled every second
+	const LogThroughput &getThroughput() const { return m_throughput; }
+	void setShowThroughput(bool show) { m_showThroughput = show; }
+	bool isShowingThroughput() const { return m_showThroughput; }
+
+	// Drains the ingestion queue; runs every frame, even while hidden
+	void update() override;
+
 	// Ensure this class is not abstract
 	void renderContents() override;
 
@@ -50,29 +92,101 @@ class LogWindow : public Window {
 	friend class LogWindowSink;
 
   private:
-	std::vector<LogEntry> m_logEntries;
-	std::mutex m_logMutex;
+	static constexpr size_t kQueueCapacity = 16384;
+
+	// Filled by any thread through LogWindowSink, drained by update()
+	MpscQueue<PendingLogEntry> m_pendingLogs{kQueueCapacity};
+	std::atomic<uint64_t> m_droppedLogs{0};
+	std::function<void()> m_wakeCallback;
+	std::atomic<bool> m_wakePosted{false};
+	LogThroughput m_throughput;
+	std::array<float, LogThroughput::kHistory> m_rateSamples = {};
+	bool m_showThroughput = true;
+	PendingLogEntry m_drainScratch;
+
+	// Retained history; only touched by the UI thread
+	LogStore m_store;
+
+	// Timestamps are formatted only for visible rows; the "HH:MM:SS" part is
+	// cached per second
+	struct TimestampPrefix {
+		int64_t second = -1;
+		char text[16] = {};
+	};
+	std::array<TimestampPrefix, 8> m_timestampPrefixes;
+	char m_timestampBuffer[32] = {};
+	int m_rateLimitInput = 0;
+
+	// Virtualized view: sequence numbers of entries passing the filters,
+	// with the first wrapped line of each (absolute, so evicting from the
+	// front only advances m_filteredStart)
+	std::vector<uint64_t> m_filtered;
+	std::vector<uint64_t> m_lineStarts;
+	size_t m_filteredStart = 0;
+	uint64_t m_indexedSeq = 0; // entries below this are indexed
+	uint64_t m_indexEndLine = 0;
+	LogSearch::Query m_indexQuery; // filters the index was built for
+	bool m_indexValid = false;
+	float m_indexWrapWidth = -1.0f;
+
+	// Spilled history paged into the view by scrolling to the top. The
+	// anchor keeps the previously first line in place once the index has
+	// been rebuilt.
+	static constexpr uint64_t kNoSeq = UINT64_MAX;
+	uint64_t m_pagedBeginSeq = kNoSeq;
+	uint64_t m_pageAnchorSeq = kNoSeq;
+	bool m_autoScroll = true;
+
+	// Text search and facet filters; while active the index is fed by the
+	// background search instead of a sequential scan
+	LogSearch m_search;
+	uint64_t m_searchedSeq = 0; // lines below this were handed to m_search
+	std::vector<uint64_t> m_searchResults;
+	char m_searchBuffer[256] = {};
+	bool m_searchRegex = false;
+	bool m_searchCaseSensitive = false;
+	int m_loggerFilter = -1;
+	int m_threadFilter = -1;
+	int m_sourceFilter = -1;
+	char m_labelBuffer[128] = {};
 	bool m_scrollToBottom = true;
 	bool m_showDebug = true;
 	bool m_showInfo = true;
 	bool m_showWarning = true;
 	bool m_showError = true;
 	bool m_showTimestamps = true; // Toggle for timestamp display
-	size_t m_maxLogLines = 1000;
 	std::shared_ptr<spdlog::sinks::sink> m_spdlogSink;
 
 	// UI methods
 	void renderLogEntries();
+	uint64_t viewBeginSeq() const;
+	void pageOlderHistory(uint64_t firstLine, float lineHeight);
+	void updateFilteredIndex(float wrapWidth);
+	void resetIndex();
+	void relayoutIndex(float wrapWidth);
+	void appendToIndex(uint64_t seq, float wrapWidth);
+	uint32_t measureLines(uint64_t seq, float wrapWidth);
+	int filterMask() const;
+	bool filtersChanged() const;
+	LogSearch::Query buildQuery() const;
 	void renderFilterControls();
+	void renderThroughputStrip();
+	void renderSparkline(const char *id, const float *values, size_t count,
+						 const ImVec4 &color);
+	void renderSearchControls();
+	bool renderFacetCombo(const char *label, int &selection, size_t count,
+						  int kind);
+	const char *facetLabel(int kind, int id);
 	void renderMenuBar();
+	void renderRepeatBadge(const LogRepeat &repeat, const LogRecord &record);
 	ImVec4 getLogColor(LogLevel level);
-	std::string getLogLevelString(LogLevel level);
+	const char *getLogLevelString(LogLevel level);
 
   protected:
-	// Methods needed by LogWindowSink
-	void addLogFromSink(LogLevel level, const std::string &message,
-						const std::string &timestamp);
-	std::string getCurrentTimestamp();
+	// Methods needed by LogWindowSink; safe to call from any thread
+	void addLogFromSink(PendingLogEntry &&entry);
+	// UI thread only; returns a buffer reused by the next call
+	const char *formatTimestamp(int64_t timeNs);
 };
 
 } // namespace blot
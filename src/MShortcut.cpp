@@ -1,11 +1,128 @@
 #include "MShortcut.h"
+#include <algorithm>
 #include <imgui.h>
+#include <spdlog/spdlog.h>
+#include "MWindow.h"
+#include "ecs/components/CWindow.h"
 #include "rendering/U_gladGlfw.h"
 
-void MShortcut::registerShortcut(ImGuiKey key, int modifiers,
+bool MShortcut::registerShortcut(ImGuiKey key, int modifiers,
 								 std::function<void()> callback,
-								 const std::string &description) {
-	m_shortcuts.push_back({key, modifiers, std::move(callback), description});
+								 const std::string &description,
+								 const std::string &scope) {
+	return registerChord({{key, modifiers}}, std::move(callback), description,
+						 scope);
+}
+
+bool MShortcut::reject(std::string reason) {
+	spdlog::warn("[MShortcut] {}", reason);
+	m_lastError = reason;
+	m_conflicts.push_back(std::move(reason));
+	return false;
+}
+
+uint32_t MShortcut::child(uint32_t node, const KeyChord &chord) const {
+	auto it = m_edges.find(edgeKey(node, chord));
+	// Edges of unregistered bindings stay; their nodes hold no bindings
+	if (it == m_edges.end() || m_nodes[it->second].bindingsBelow == 0)
+		return kNoNode;
+	return it->second;
+}
+
+uint32_t MShortcut::scopeRoot(const std::string &scope, bool create) {
+	auto it = m_scopeRoots.find(scope);
+	if (it != m_scopeRoots.end())
+		return it->second;
+	if (!create)
+		return kNoNode;
+	const uint32_t root = static_cast<uint32_t>(m_nodes.size());
+	m_nodes.emplace_back();
+	m_scopeRoots.emplace(scope, root);
+	m_focusDirty = true;
+	return root;
+}
+
+bool MShortcut::registerChord(const std::vector<KeyChord> &sequence,
+							  std::function<void()> callback,
+							  const std::string &description,
+							  const std::string &scope) {
+	const std::string where = scope.empty() ? "global" : "'" + scope + "'";
+	const std::string name = formatSequence(sequence);
+	if (sequence.empty() || !callback)
+		return reject("Shortcut '" + description + "' has no keys or callback");
+
+	// Walk the existing path: no binding may sit on it, or under its end
+	const uint32_t root = scopeRoot(scope, true);
+	uint32_t node = root;
+	size_t depth = 0;
+	for (; depth < sequence.size(); depth++) {
+		const uint32_t next = child(node, sequence[depth]);
+		if (next == kNoNode)
+			break;
+		node = next;
+		const int bound = m_nodes[node].binding;
+		if (bound >= 0) {
+			const Shortcut &other = m_shortcuts[bound];
+			return reject(name + " (" + description + ") conflicts with " +
+						  formatSequence(other.sequence) + " (" +
+						  other.description + ") in " + where + " scope");
+		}
+	}
+	if (depth == sequence.size())
+		return reject(name + " (" + description + ") is a prefix of other " +
+					  "chords in " + where + " scope");
+
+	const int binding = static_cast<int>(m_shortcuts.size());
+	m_shortcuts.push_back(
+		{sequence, std::move(callback), description, scope, true});
+	node = root;
+	m_nodes[root].bindingsBelow++;
+	for (const KeyChord &chord : sequence) {
+		auto it = m_edges.find(edgeKey(node, chord));
+		uint32_t next = 0;
+		if (it != m_edges.end()) {
+			next = it->second;
+		} else {
+			next = static_cast<uint32_t>(m_nodes.size());
+			m_nodes.emplace_back();
+			m_edges.emplace(edgeKey(node, chord), next);
+		}
+		node = next;
+		m_nodes[node].bindingsBelow++;
+		if (std::find(m_keys.begin(), m_keys.end(), chord.key) == m_keys.end())
+			m_keys.push_back(chord.key);
+	}
+	m_nodes[node].binding = binding;
+	return true;
+}
+
+bool MShortcut::unregisterShortcut(const std::vector<KeyChord> &sequence,
+								   const std::string &scope) {
+	const uint32_t root = scopeRoot(scope, false);
+	if (root == kNoNode || sequence.empty())
+		return false;
+	std::vector<uint32_t> path{root};
+	for (const KeyChord &chord : sequence) {
+		const uint32_t next = child(path.back(), chord);
+		if (next == kNoNode)
+			return false;
+		path.push_back(next);
+	}
+	Node &end = m_nodes[path.back()];
+	if (end.binding < 0)
+		return false;
+	m_shortcuts[end.binding].active = false;
+	m_shortcuts[end.binding].callback = nullptr;
+	end.binding = -1;
+	for (uint32_t node : path)
+		m_nodes[node].bindingsBelow--;
+	m_pendingNode = kNoNode;
+	return true;
+}
+
+void MShortcut::setWindowManager(blot::MWindow *windowManager) {
+	m_windowManager = windowManager;
+	m_focusDirty = true;
 }
 
 int MShortcut::getCurrentModifiers() {
@@ -22,10 +139,82 @@ int MShortcut::getCurrentModifiers() {
 	return mods;
 }
 
+std::string MShortcut::formatSequence(const std::vector<KeyChord> &sequence) {
+	std::string text;
+	for (const KeyChord &chord : sequence) {
+		if (!text.empty())
+			text += ", ";
+		if (chord.modifiers & Mod_Ctrl)
+			text += "Ctrl+";
+		if (chord.modifiers & Mod_Shift)
+			text += "Shift+";
+		if (chord.modifiers & Mod_Alt)
+			text += "Alt+";
+		if (chord.modifiers & Mod_Super)
+			text += "Super+";
+		text += ImGui::GetKeyName(chord.key);
+	}
+	return text;
+}
+
+void MShortcut::resolveFocusedScope() {
+	// Only a focus change (or a new scope) needs the name lookup
+	const entt::entity focused = m_windowManager
+									 ? m_windowManager->getFocusedWindowEntity()
+									 : entt::entity(entt::null);
+	if (focused == m_focusedEntity && !m_focusDirty)
+		return;
+	if (focused != m_focusedEntity)
+		m_pendingNode = kNoNode; // a chord does not survive a focus change
+	m_focusedEntity = focused;
+	m_focusDirty = false;
+	m_focusedScope = kNoNode;
+	if (focused == entt::null)
+		return;
+	const auto *window =
+		m_windowManager->getRegistry().try_get<blot::ecs::CWindow>(focused);
+	if (window && !window->name.empty())
+		m_focusedScope = scopeRoot(window->name, false);
+}
+
+void MShortcut::dispatch(const KeyChord &chord, double now,
+						 bool globalEnabled) {
+	uint32_t node = kNoNode;
+	if (m_pendingNode != kNoNode) {
+		// Mid-sequence: a chord that does not continue it is swallowed
+		node = child(m_pendingNode, chord);
+		m_pendingNode = kNoNode;
+	} else {
+		if (m_focusedScope != kNoNode)
+			node = child(m_focusedScope, chord);
+		if (node == kNoNode && globalEnabled) {
+			const uint32_t global = scopeRoot("", false);
+			if (global != kNoNode)
+				node = child(global, chord);
+		}
+	}
+	if (node == kNoNode)
+		return;
+	const int binding = m_nodes[node].binding;
+	if (binding < 0) {
+		m_pendingNode = node;
+		m_pendingTime = now;
+		return;
+	}
+	// Copied: the callback may register shortcuts and grow m_shortcuts
+	std::function<void()> callback = m_shortcuts[binding].callback;
+	callback();
+}
+
 void MShortcut::processShortcuts() {
 	ImGuiIO &io = ImGui::GetIO();
-	if (io.WantCaptureKeyboard)
+	// Text fields keep their keys. Global bindings also yield whenever ImGui
+	// wants the keyboard (e.g. keyboard navigation in a focused window);
+	// bindings scoped to that window are meant for exactly that case.
+	if (io.WantTextInput) {
+		m_pendingNode = kNoNode;
 		return;
+	}
 
 	// F1 toggles help overlay
 	static bool f1Pressed = false;
@@ -38,12 +227,17 @@ void MShortcut::processShortcuts() {
 		f1Pressed = false;
 	}
 
-	int currentMods = getCurrentModifiers();
-	for (const auto &shortcut : m_shortcuts) {
-		if (ImGui::IsKeyPressed(shortcut.key, false) &&
-			(getCurrentModifiers() == shortcut.modifiers)) {
-			shortcut.callback();
-		}
+	const double now = ImGui::GetTime();
+	if (m_pendingNode != kNoNode && now - m_pendingTime > m_chordTimeout)
+		m_pendingNode = kNoNode;
+	resolveFocusedScope();
+
+	const bool globalEnabled = !io.WantCaptureKeyboard;
+	const int currentMods = getCurrentModifiers();
+	// Indexed: a callback may register shortcuts and grow m_keys
+	for (size_t i = 0; i < m_keys.size(); i++) {
+		if (ImGui::IsKeyPressed(m_keys[i], false))
+			dispatch({m_keys[i], currentMods}, now, globalEnabled);
 	}
 }
 
@@ -54,19 +248,32 @@ void MShortcut::showHelpOverlay() {
 				 ImGuiWindowFlags_AlwaysAutoResize);
 	ImGui::Text("Keyboard Shortcuts:");
 	ImGui::Separator();
-	for (const auto &shortcut : m_shortcuts) {
-		std::string modStr;
-		if (shortcut.modifiers & Mod_Ctrl)
-			modStr += "Ctrl+";
-		if (shortcut.modifiers & Mod_Shift)
-			modStr += "Shift+";
-		if (shortcut.modifiers & Mod_Alt)
-			modStr += "Alt+";
-		if (shortcut.modifiers & Mod_Super)
-			modStr += "Super+";
-		ImGui::BulletText("%s%s: %s", modStr.c_str(),
-						  glfwGetKeyName(shortcut.key, 0),
-						  shortcut.description.c_str());
+
+	// Global bindings first, then each window scope
+	std::vector<std::string> scopes;
+	for (const auto &entry : m_scopeRoots)
+		scopes.push_back(entry.first);
+	std::sort(scopes.begin(), scopes.end());
+	for (const std::string &scope : scopes) {
+		bool header = false;
+		for (const auto &shortcut : m_shortcuts) {
+			if (!shortcut.active || shortcut.scope != scope)
+				continue;
+			if (!header && !scope.empty()) {
+				ImGui::Separator();
+				ImGui::TextDisabled("%s", scope.c_str());
+			}
+			header = true;
+			ImGui::BulletText("%s: %s",
+							  formatSequence(shortcut.sequence).c_str(),
+							  shortcut.description.c_str());
+		}
+	}
+	if (!m_conflicts.empty()) {
+		ImGui::Separator();
+		ImGui::TextDisabled("Conflicts");
+		for (const std::string &conflict : m_conflicts)
+			ImGui::BulletText("%s", conflict.c_str());
 	}
 	ImGui::End();
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <entt/entt.hpp>
 #include <functional>
 #include <imgui.h>
 #include <string>
@@ -7,6 +9,10 @@
 #include <vector>
 #include "rendering/U_gladGlfw.h"
 
+namespace blot {
+class MWindow;
+}
+
 // Modifier bitmask
 enum ShortcutModifier {
 	Mod_None = 0,
@@ -16,25 +22,93 @@ enum ShortcutModifier {
 	Mod_Super = 1 << 3
 };
 
-struct Shortcut {
+// One key press with the modifiers held
+struct KeyChord {
 	ImGuiKey key;  // ImGuiKey_*
 	int modifiers; // ShortcutModifier bitmask
+};
+
+struct Shortcut {
+	std::vector<KeyChord> sequence; // one chord, or several pressed in turn
 	std::function<void()> callback;
 	std::string description;
+	std::string scope; // window name, or empty for global
+	bool active = true;
 };
 
+// Keyboard shortcuts resolved through a hash table keyed by (node, key,
+// modifiers), so a key press costs one lookup however many bindings exist.
+// Each scope (the global one, or a window by name) is a tree of chords:
+// a binding is a path from the scope's root, and a multi-chord sequence
+// waits for its next chord until the timeout. Bindings of the window MWindow
+// reports as focused shadow global ones, and work while ImGui has keyboard
+// focus, where global ones yield. A sequence that is bound already,
+// or is a prefix of a bound chord sequence (or has one as a prefix), is
+// rejected at registration.
 class MShortcut {
   public:
-	void registerShortcut(ImGuiKey key, int modifiers,
+	// Returns false, with the reason in getLastError(), on a conflict
+	bool registerShortcut(ImGuiKey key, int modifiers,
 						  std::function<void()> callback,
-						  const std::string &description);
+						  const std::string &description,
+						  const std::string &scope = "");
+	bool registerChord(const std::vector<KeyChord> &sequence,
+					   std::function<void()> callback,
+					   const std::string &description,
+					   const std::string &scope = "");
+	bool unregisterShortcut(const std::vector<KeyChord> &sequence,
+							const std::string &scope = "");
 	void processShortcuts();
 	void showHelpOverlay();
 
+	// Source of the focused window for scoped bindings
+	void setWindowManager(blot::MWindow *windowManager);
+	void setChordTimeout(double seconds) { m_chordTimeout = seconds; }
+	bool isChordPending() const { return m_pendingNode != kNoNode; }
+	const std::string &getLastError() const { return m_lastError; }
+	// Every rejected registration, for the help overlay
+	const std::vector<std::string> &getConflicts() const { return m_conflicts; }
+
 	// Utility
 	static int getCurrentModifiers();
+	// "Ctrl+K, Ctrl+C"
+	static std::string formatSequence(const std::vector<KeyChord> &sequence);
 
   private:
+	static constexpr uint32_t kNoNode = UINT32_MAX;
+
+	struct Node {
+		int binding = -1; // index into m_shortcuts
+		uint32_t bindingsBelow = 0; // bindings at or under this node
+	};
+
+	static uint64_t edgeKey(uint32_t node, const KeyChord &chord) {
+		return (uint64_t(node) << 32) | (uint64_t(chord.key) << 4) |
+			   uint64_t(chord.modifiers & 0xF);
+	}
+	uint32_t child(uint32_t node, const KeyChord &chord) const;
+	uint32_t scopeRoot(const std::string &scope, bool create);
+	void resolveFocusedScope();
+	void dispatch(const KeyChord &chord, double now, bool globalEnabled);
+	bool reject(std::string reason);
+
 	std::vector<Shortcut> m_shortcuts;
+	std::vector<Node> m_nodes;
+	std::unordered_map<uint64_t, uint32_t> m_edges;
+	std::unordered_map<std::string, uint32_t> m_scopeRoots;
+	// Keys any binding uses; the only ones polled each frame
+	std::vector<ImGuiKey> m_keys;
+
+	blot::MWindow *m_windowManager = nullptr;
+	entt::entity m_focusedEntity = entt::null;
+	uint32_t m_focusedScope = kNoNode;
+	bool m_focusDirty = true;
+
+	uint32_t m_pendingNode = kNoNode;
+	double m_pendingTime = 0.0;
+	double m_chordTimeout = 1.0;
+
+	std::string m_lastError;
+	std::vector<std::string> m_conflicts;
 	bool m_showHelp = false;
 };
@@ -11,10 +11,20 @@
 #include "ecs/components/CTransform.h"
 #include "ecs/components/CWindow.h"
 #include "imgui.h"
+#include "imgui_internal.h"
 
 namespace blot {
 
 MWindow::MWindow() : m_focusedWindowEntity(entt::null) {
+	// Owning group: CWindowInstance/CWindow are packed together so
+	// renderAllWindows() walks contiguous memory
+	m_registry.group<CWindowInstance, ecs::CWindow>(
+		entt::get<ecs::CWindowTransform, ecs::CWindowStyle>);
+	m_registry.on_update<ecs::CWindowTransform>()
+		.connect<&MWindow::onWindowComponentUpdated>(this);
+	m_registry.on_update<ecs::CWindowStyle>()
+		.connect<&MWindow::onWindowComponentUpdated>(this);
+
 	m_workspaceDir = AppPaths::getWorkspacesDir();
 	m_mainIniPath = AppPaths::getImGuiIniPath();
 	spdlog::debug("[DEBUG] MWindow constructed, workspaceDir={}",
@@ -36,18 +46,21 @@ entt::entity MWindow::createWindow(const std::string &name,
 	auto entity = m_registry.create();
 
 	// Add components
-	m_windowMap[entity] = window;
+	m_nameIndex.emplace(name, entity);
 
 	ecs::CWindow comp;
 	comp.name = name;
 	comp.isVisible = true;
 	comp.isFocused = false;
-	comp.zOrder = 0;
+	// New windows start on top of the stack
+	comp.zOrder = ++m_nextZOrder;
 
 	m_registry.emplace<ecs::CWindow>(entity, comp);
 	m_registry.emplace<ecs::CWindowTransform>(entity);
 	m_registry.emplace<ecs::CWindowStyle>(entity);
 	m_registry.emplace<ecs::CWindowInput>(entity);
+	m_registry.emplace<CWindowInstance>(entity, std::move(window));
+	m_zOrderDirty = true;
 
 	// If this is the first window, make it focused
 	if (m_focusedWindowEntity == entt::null) {
@@ -65,7 +78,9 @@ void MWindow::destroyWindow(entt::entity windowEntity) {
 		if (windowEntity == m_focusedWindowEntity) {
 			m_focusedWindowEntity = entt::null;
 		}
-		m_windowMap.erase(windowEntity);
+		if (auto *windowComp = m_registry.try_get<ecs::CWindow>(windowEntity)) {
+			m_nameIndex.erase(windowComp->name);
+		}
 		m_registry.destroy(windowEntity);
 	}
 }
@@ -77,20 +92,18 @@ void MWindow::destroyWindow(const std::string &windowName) {
 	}
 }
 
-entt::entity MWindow::getWindowEntity(const std::string &name) {
-	auto view = m_registry.view<ecs::CWindow>();
-	for (auto entity : view) {
-		auto &windowComp = view.get<ecs::CWindow>(entity);
-		if (windowComp.name == name) {
-			return entity;
-		}
-	}
-	return entt::null;
+entt::entity MWindow::getWindowEntity(const std::string &name) const {
+	auto it = m_nameIndex.find(name);
+	return it != m_nameIndex.end() ? it->second : entt::null;
+}
+
+bool MWindow::isValidWindow(entt::entity e) const {
+	return e != entt::null && m_registry.valid(e) &&
+		   m_registry.all_of<ecs::CWindow>(e);
 }
 
 std::shared_ptr<Window> MWindow::getWindow(entt::entity e) {
-	auto it = m_windowMap.find(e);
-	return it != m_windowMap.end() ? it->second : nullptr;
+	return static_cast<const MWindow &>(*this).getWindow(e);
 }
 
 std::shared_ptr<Window> MWindow::getWindow(const std::string &name) {
@@ -98,15 +111,16 @@ std::shared_ptr<Window> MWindow::getWindow(const std::string &name) {
 }
 
 std::shared_ptr<Window> MWindow::getWindow(entt::entity e) const {
-	auto it = m_windowMap.find(e);
-	return it != m_windowMap.end() ? it->second : nullptr;
+	if (e == entt::null || !m_registry.valid(e))
+		return nullptr;
+	auto *instance = m_registry.try_get<CWindowInstance>(e);
+	return instance ? instance->window : nullptr;
 }
 
 std::shared_ptr<Window> MWindow::getFocusedWindow() {
 	if (m_focusedWindowEntity != entt::null &&
 		m_registry.valid(m_focusedWindowEntity)) {
-		auto &windowComp = m_registry.get<ecs::CWindow>(m_focusedWindowEntity);
-		return m_windowMap[m_focusedWindowEntity];
+		return getWindow(m_focusedWindowEntity);
 	}
 	return nullptr;
 }
@@ -126,43 +140,31 @@ std::vector<std::string> MWindow::getAllWindowNames() const {
 std::vector<std::pair<std::string, std::string>>
 MWindow::getAllWindowsWithDisplayNames() const {
 	std::vector<std::pair<std::string, std::string>> windows;
-	auto view = m_registry.view<ecs::CWindow>();
+	auto view = m_registry.view<ecs::CWindow, CWindowInstance>();
 	for (auto entity : view) {
 		const auto &windowComp = view.get<ecs::CWindow>(entity);
+		const auto &instance = view.get<CWindowInstance>(entity);
 		// Use the window's title for display, fallback to name if window is
 		// null
-		std::string displayName = m_windowMap.at(entity)
-									  ? m_windowMap.at(entity)->getTitle()
-									  : windowComp.name;
+		std::string displayName =
+			instance.window ? instance.window->getTitle() : windowComp.name;
 		windows.push_back({windowComp.name, displayName});
 	}
 	return windows;
 }
 
 void MWindow::showWindow(const std::string &name) {
-	auto entity = getWindowEntity(name);
-	if (entity != entt::null) {
-		auto &windowComp = m_registry.get<ecs::CWindow>(entity);
-		windowComp.isVisible = true;
-		auto wnd = getWindow(entity);
-		if (wnd) {
-			wnd->show();
-		}
-	}
+	showWindow(getWindowEntity(name));
 }
 
+void MWindow::showWindow(entt::entity e) { setWindowVisible(e, true); }
+
 void MWindow::hideWindow(const std::string &name) {
-	auto entity = getWindowEntity(name);
-	if (entity != entt::null) {
-		auto &windowComp = m_registry.get<ecs::CWindow>(entity);
-		windowComp.isVisible = false;
-		auto wnd = getWindow(entity);
-		if (wnd) {
-			wnd->hide();
-		}
-	}
+	hideWindow(getWindowEntity(name));
 }
 
+void MWindow::hideWindow(entt::entity e) { setWindowVisible(e, false); }
+
 void MWindow::closeWindow(const std::string &name) {
 	auto entity = getWindowEntity(name);
 	if (entity != entt::null) {
@@ -176,8 +178,11 @@ void MWindow::closeWindow(const std::string &name) {
 }
 
 void MWindow::focusWindow(const std::string &name) {
-	auto entity = getWindowEntity(name);
-	if (entity != entt::null) {
+	focusWindow(getWindowEntity(name));
+}
+
+void MWindow::focusWindow(entt::entity entity) {
+	if (isValidWindow(entity)) {
 		// Clear previous focus
 		if (m_focusedWindowEntity != entt::null &&
 			m_registry.valid(m_focusedWindowEntity)) {
@@ -190,9 +195,51 @@ void MWindow::focusWindow(const std::string &name) {
 		m_focusedWindowEntity = entity;
 		auto &windowComp = m_registry.get<ecs::CWindow>(entity);
 		windowComp.isFocused = true;
+		bringToFront(entity);
+		if (auto wnd = getWindow(entity)) {
+			wnd->requestFocus();
+		}
 	}
 }
 
+void MWindow::setWindowUpdatePolicy(const std::string &name,
+									Window::UpdatePolicy policy,
+									float rateHz) {
+	setWindowUpdatePolicy(getWindowEntity(name), policy, rateHz);
+}
+
+void MWindow::setWindowUpdatePolicy(entt::entity e,
+									Window::UpdatePolicy policy,
+									float rateHz) {
+	if (auto wnd = getWindow(e)) {
+		wnd->setUpdatePolicy(policy, rateHz);
+	}
+}
+
+void MWindow::invalidateWindow(entt::entity e) {
+	if (auto wnd = getWindow(e)) {
+		wnd->invalidate();
+	}
+}
+
+void MWindow::invalidateAllWindows() {
+	for (auto [entity, instance] : m_registry.view<CWindowInstance>().each()) {
+		if (instance.window) {
+			instance.window->invalidate();
+		}
+	}
+}
+
+void MWindow::bringToFront(entt::entity e) {
+	if (!isValidWindow(e))
+		return;
+	auto &windowComp = m_registry.get<ecs::CWindow>(e);
+	if (windowComp.zOrder == m_nextZOrder)
+		return;
+	windowComp.zOrder = ++m_nextZOrder;
+	m_zOrderDirty = true;
+}
+
 void MWindow::closeFocusedWindow() {
 	if (m_focusedWindowEntity != entt::null &&
 		m_registry.valid(m_focusedWindowEntity)) {
@@ -207,17 +254,16 @@ void MWindow::closeFocusedWindow() {
 }
 
 void MWindow::closeAllWindows() {
-	auto view = m_registry.view<ecs::CWindow>();
-	for (auto entity : view) {
-		auto &windowComp = view.get<ecs::CWindow>(entity);
-		auto wnd = getWindow(entity);
-		if (wnd) {
-			wnd->close();
+	for (auto [entity, instance] : m_registry.view<CWindowInstance>().each()) {
+		if (instance.window) {
+			instance.window->close();
 		}
 	}
-	m_windowMap.clear();
+	m_nameIndex.clear();
 	m_registry.clear();
 	m_focusedWindowEntity = entt::null;
+	m_nextZOrder = 0;
+	m_zOrderDirty = false;
 }
 
 void MWindow::renderAllWindows() {
@@ -225,31 +271,90 @@ void MWindow::renderAllWindows() {
 	// Sort windows by z-order
 	sortWindowsByZOrder();
 
-	// Render all visible windows
-	auto view =
-		m_registry
-			.view<ecs::CWindow, ecs::CWindowTransform, ecs::CWindowStyle>();
-	for (auto entity : view) {
-		auto &windowComp = view.get<ecs::CWindow>(entity);
-		auto &transformComp = view.get<ecs::CWindowTransform>(entity);
-		auto &styleComp = view.get<ecs::CWindowStyle>(entity);
+	if (m_occlusionCulling) {
+		cullOccludedWindows();
+	}
 
-		if (windowComp.isVisible && m_windowMap[entity]) {
-			// Apply transform and style
-			m_windowMap[entity]->setPosition(transformComp.position);
-			m_windowMap[entity]->setSize(transformComp.size);
-			m_windowMap[entity]->setMinSize(transformComp.minSize);
-			m_windowMap[entity]->setMaxSize(transformComp.maxSize);
-			m_windowMap[entity]->setAlpha(styleComp.alpha);
-			m_windowMap[entity]->setFlags(
-				static_cast<Window::Flags>(styleComp.flags));
+	// Render all visible windows, back to front
+	auto group = m_registry.group<CWindowInstance, ecs::CWindow>(
+		entt::get<ecs::CWindowTransform, ecs::CWindowStyle>);
+	FrameProfiler *profiler = m_profiler;
+	auto renderInstance = [profiler](CWindowInstance &instance,
+									 ecs::CWindowTransform &transformComp,
+									 ecs::CWindowStyle &styleComp) {
+		Window *window = instance.window.get();
+		// Apply transform and style only when they changed
+		if (instance.dirty) {
+			window->setPosition(transformComp.position);
+			window->setSize(transformComp.size);
+			window->setMinSize(transformComp.minSize);
+			window->setMaxSize(transformComp.maxSize);
+			window->setAlpha(styleComp.alpha);
+			window->setFlags(static_cast<Window::Flags>(styleComp.flags));
+			instance.dirty = false;
+		}
 
-			// Render the window
-			m_windowMap[entity]->render();
+		// Render the window
+		if (profiler && !instance.profilerResolved) {
+			instance.profilerTrack =
+				profiler->registerTrack(window->getTitle());
+			instance.profilerResolved = true;
 		}
+		FrameProfiler::Scope scope(profiler, instance.profilerTrack);
+		window->render();
+	};
+	group.each([&renderInstance](CWindowInstance &instance,
+								 ecs::CWindow &windowComp,
+								 ecs::CWindowTransform &transformComp,
+								 ecs::CWindowStyle &styleComp) {
+		Window *window = instance.window.get();
+		if (window)
+			window->update();
+		if (!windowComp.isVisible || !window || instance.culled)
+			return;
+		renderInstance(instance, transformComp, styleComp);
+	});
+
+	if (m_culledWindowCount > 0) {
+		// Culling used last frame's rects. An occluder that was closed,
+		// hidden or moved this frame no longer covers its window; draw that
+		// one now rather than a frame late. Display order comes from ImGui's
+		// window list, not submission order, so it still lands underneath.
+		for (auto entity : group) {
+			auto [instance, windowComp, transformComp, styleComp] =
+				group.get<CWindowInstance, ecs::CWindow, ecs::CWindowTransform,
+						  ecs::CWindowStyle>(entity);
+			if (!instance.culled)
+				continue;
+			const ::ImGuiWindow *occluder = instance.occluder;
+			const ::ImGuiWindow *imWindow =
+				ImGui::FindWindowByID(instance.imguiId);
+			if (occluder && imWindow && occluder->Active &&
+				!occluder->Hidden && !occluder->Collapsed &&
+				occluder->Rect().Contains(imWindow->Rect()))
+				continue;
+			instance.culled = false;
+			instance.occluder = nullptr;
+			--m_culledWindowCount;
+			if (windowComp.isVisible && instance.window &&
+				instance.window->isOpen())
+				renderInstance(instance, transformComp, styleComp);
+		}
+	}
+}
+
+void MWindow::markWindowDirty(entt::entity e) {
+	if (e == entt::null || !m_registry.valid(e))
+		return;
+	if (auto *instance = m_registry.try_get<CWindowInstance>(e)) {
+		instance->dirty = true;
 	}
 }
 
+void MWindow::onWindowComponentUpdated(entt::registry &, entt::entity e) {
+	markWindowDirty(e);
+}
+
 void MWindow::handleInput() {
 	// Handle ESC key to close focused window
 	handleEscapeKey();
@@ -260,13 +365,15 @@ void MWindow::handleInput() {
 
 void MWindow::update() {
 	// Update all window states
-	auto view = m_registry.view<ecs::CWindow>();
-	for (auto entity : view) {
-		auto &windowComp = view.get<ecs::CWindow>(entity);
-		if (m_windowMap[entity]) {
+	auto group = m_registry.group<CWindowInstance, ecs::CWindow>(
+		entt::get<ecs::CWindowTransform, ecs::CWindowStyle>);
+	for (auto entity : group) {
+		auto [instance, windowComp] =
+			group.get<CWindowInstance, ecs::CWindow>(entity);
+		if (instance.window) {
 			// Update window state from ImGui
-			windowComp.isFocused = m_windowMap[entity]->isFocused();
-			windowComp.isVisible = m_windowMap[entity]->isVisible();
+			windowComp.isFocused = instance.window->isFocused();
+			windowComp.isVisible = instance.window->isVisible();
 		}
 	}
 
@@ -274,14 +381,31 @@ void MWindow::update() {
 	handleInput();
 }
 
+bool MWindow::hasRedrawRequests() const {
+	for (auto [entity, instance] : m_registry.view<CWindowInstance>().each()) {
+		if (instance.window && instance.window->hasRedrawRequest()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool MWindow::consumeRedrawRequests() {
+	bool requested = false;
+	for (auto [entity, instance] : m_registry.view<CWindowInstance>().each()) {
+		if (instance.window && instance.window->consumeRedrawRequest()) {
+			requested = true;
+		}
+	}
+	return requested;
+}
+
 void MWindow::updateFocus() {
 	// Find the currently focused window in ImGui
 	entt::entity newFocusedEntity = entt::null;
 
-	auto view = m_registry.view<ecs::CWindow>();
-	for (auto entity : view) {
-		auto &windowComp = view.get<ecs::CWindow>(entity);
-		if (m_windowMap[entity] && m_windowMap[entity]->isFocused()) {
+	for (auto [entity, instance] : m_registry.view<CWindowInstance>().each()) {
+		if (instance.window && instance.window->isFocused()) {
 			newFocusedEntity = entity;
 			break;
 		}
@@ -302,6 +426,7 @@ void MWindow::updateFocus() {
 		if (newFocusedEntity != entt::null) {
 			auto &windowComp = m_registry.get<ecs::CWindow>(newFocusedEntity);
 			windowComp.isFocused = true;
+			bringToFront(newFocusedEntity);
 		}
 	}
 }
@@ -323,24 +448,119 @@ void MWindow::handleEscapeKey() {
 }
 
 void MWindow::sortWindowsByZOrder() {
-	// This would sort windows by z-order for proper rendering
-	// For now, we'll use the default entity order
-	// In a more complex implementation, you might want to sort the view
+	if (!m_zOrderDirty)
+		return;
+	// Only focus changes and new windows move entries, so the pool is nearly
+	// sorted: insertion sort makes this O(n) in practice. Sorting through the
+	// owning group keeps CWindowInstance packed in the same order.
+	auto group = m_registry.group<CWindowInstance, ecs::CWindow>(
+		entt::get<ecs::CWindowTransform, ecs::CWindowStyle>);
+	group.sort<ecs::CWindow>(
+		[](const ecs::CWindow &lhs, const ecs::CWindow &rhs) {
+			return lhs.zOrder < rhs.zOrder;
+		},
+		entt::insertion_sort{});
+	m_zOrderDirty = false;
+}
+
+void MWindow::setOcclusionCulling(bool enabled) {
+	m_occlusionCulling = enabled;
+	if (!enabled) {
+		for (auto [entity, instance] :
+			 m_registry.view<CWindowInstance>().each()) {
+			instance.culled = false;
+		}
+		m_culledWindowCount = 0;
+	}
+}
+
+// A window that can be skipped or act as an occluder: submitted last frame
+// (or culled, which keeps its last rect and dock state), floating (not
+// docked, not a child/popup) and not collapsed
+static bool isFloatingImGuiWindow(const ::ImGuiWindow *w, bool wasCulled) {
+	if (!w || !(w->WasActive || wasCulled) || w->Hidden || w->Collapsed ||
+		w->DockIsActive)
+		return false;
+	return (w->Flags & (ImGuiWindowFlags_ChildWindow | ImGuiWindowFlags_Popup |
+						ImGuiWindowFlags_Tooltip)) == 0;
+}
+
+void MWindow::cullOccludedWindows() {
+	m_culledWindowCount = 0;
+	m_occluders.clear();
+	ImGuiContext &g = *ImGui::GetCurrentContext();
+	const bool opaqueStyle =
+		g.Style.Alpha >= 1.0f && g.Style.Colors[ImGuiCol_WindowBg].w >= 1.0f;
+
+	// Walk top-most first, collecting opaque floating windows as occluders.
+	// Window rects are from the previous frame, so windows being moved or
+	// resized never occlude (their new rect is not known yet).
+	auto group = m_registry.group<CWindowInstance, ecs::CWindow>(
+		entt::get<ecs::CWindowTransform, ecs::CWindowStyle>);
+	for (auto it = group.rbegin(); it != group.rend(); ++it) {
+		auto [instance, windowComp] =
+			group.get<CWindowInstance, ecs::CWindow>(*it);
+		const bool wasCulled = instance.culled;
+		instance.culled = false;
+		instance.occluder = nullptr;
+		if (!windowComp.isVisible || !instance.window)
+			continue;
+		if (instance.imguiId == 0) {
+			instance.imguiId = ImHashStr(instance.window->getTitle().c_str());
+		}
+		::ImGuiWindow *imWindow = ImGui::FindWindowByID(instance.imguiId);
+		if (!isFloatingImGuiWindow(imWindow, wasCulled))
+			continue;
+
+		// Never cull what the user is interacting with, nor a window whose
+		// pending transform moves it this frame
+		bool interacting = windowComp.isFocused || imWindow == g.NavWindow ||
+						   imWindow == g.HoveredWindow ||
+						   imWindow == g.ActiveIdWindow || instance.dirty;
+		if (!interacting) {
+			const ImRect rect = imWindow->Rect();
+			const int displayIndex = ImGui::FindWindowDisplayIndex(imWindow);
+			for (::ImGuiWindow *occluder : m_occluders) {
+				if (occluder->Viewport == imWindow->Viewport &&
+					ImGui::FindWindowDisplayIndex(occluder) > displayIndex &&
+					occluder->Rect().Contains(rect)) {
+					instance.culled = true;
+					instance.occluder = occluder;
+					++m_culledWindowCount;
+					break;
+				}
+			}
+		}
+
+		// Occluders must be drawn this frame where they were last frame
+		if (!instance.culled && imWindow->WasActive &&
+			!instance.dirty && instance.window->isOpen() && opaqueStyle &&
+			instance.window->getAlpha() >= 1.0f &&
+			!(imWindow->Flags & ImGuiWindowFlags_NoBackground) &&
+			imWindow != g.MovingWindow && imWindow != g.ActiveIdWindow) {
+			m_occluders.push_back(imWindow);
+		}
+	}
 }
 
 // Window visibility management
 bool MWindow::isWindowVisible(const std::string &name) {
-	auto entity = getWindowEntity(name);
-	if (entity != entt::null) {
-		auto &windowComp = m_registry.get<ecs::CWindow>(entity);
-		return windowComp.isVisible;
+	return isWindowVisible(getWindowEntity(name));
+}
+
+bool MWindow::isWindowVisible(entt::entity entity) const {
+	if (isValidWindow(entity)) {
+		return m_registry.get<ecs::CWindow>(entity).isVisible;
 	}
 	return false;
 }
 
 void MWindow::setWindowVisible(const std::string &name, bool visible) {
-	auto entity = getWindowEntity(name);
-	if (entity != entt::null) {
+	setWindowVisible(getWindowEntity(name), visible);
+}
+
+void MWindow::setWindowVisible(entt::entity entity, bool visible) {
+	if (isValidWindow(entity)) {
 		auto &windowComp = m_registry.get<ecs::CWindow>(entity);
 		windowComp.isVisible = visible;
 		auto wnd = getWindow(entity);
@@ -355,8 +575,11 @@ void MWindow::setWindowVisible(const std::string &name, bool visible) {
 }
 
 void MWindow::toggleWindow(const std::string &name) {
-	auto entity = getWindowEntity(name);
-	if (entity != entt::null) {
+	toggleWindow(getWindowEntity(name));
+}
+
+void MWindow::toggleWindow(entt::entity entity) {
+	if (isValidWindow(entity)) {
 		auto &windowComp = m_registry.get<ecs::CWindow>(entity);
 		windowComp.isVisible = !windowComp.isVisible;
 		auto wnd = getWindow(entity);
@@ -383,11 +606,14 @@ void MWindow::showAllWindows() {
 }
 
 void MWindow::hideAllWindows(const std::vector<std::string> &except) {
-	auto allWindows = getAllWindowNames();
-	for (const auto &name : allWindows) {
-		if (std::find(except.begin(), except.end(), name) != except.end())
+	auto view = m_registry.view<ecs::CWindow>();
+	for (auto entity : view) {
+		const auto &windowComp = view.get<ecs::CWindow>(entity);
+		if (!windowComp.isVisible ||
+			std::find(except.begin(), except.end(), windowComp.name) !=
+				except.end())
 			continue;
-		setWindowVisible(name, false);
+		setWindowVisible(entity, false);
 	}
 }
 
@@ -441,15 +667,15 @@ MWindow::getWindowsByCategory(const std::string &category) {
 // Menu integration
 void MWindow::renderWindowMenu() {
 	if (ImGui::BeginMenu("Windows")) {
-		auto view = m_registry.view<ecs::CWindow>();
+		auto view = m_registry.view<ecs::CWindow, CWindowInstance>();
 		for (auto entity : view) {
 			auto &windowComp = view.get<ecs::CWindow>(entity);
 
-			if (m_windowMap[entity]) {
+			if (view.get<CWindowInstance>(entity).window) {
 				bool isVisible = windowComp.isVisible;
 				if (ImGui::MenuItem(windowComp.name.c_str(), nullptr,
 									&isVisible)) {
-					setWindowVisible(windowComp.name, isVisible);
+					setWindowVisible(entity, isVisible);
 				}
 			}
 		}
@@ -494,17 +720,16 @@ bool MWindow::loadWorkspace(const std::string &workspaceName) {
 	for (const auto &[k, v] : config.windowVisibility)
 		spdlog::info(" '{}'", k);
 	spdlog::info("");
-	// Set all windows to visible by default, then apply config
-	std::vector<std::string> allWindows = getAllWindowNames();
-	std::set<std::string> allWindowSet(allWindows.begin(), allWindows.end());
-	for (const auto &windowName : allWindows) {
-		setWindowVisible(windowName, false);
+	// Hide all windows, then apply config
+	for (auto entity : m_registry.view<ecs::CWindow>()) {
+		setWindowVisible(entity, false);
 	}
 	std::set<std::string> missingWindows;
 	// Show only those listed as true in the config
 	for (const auto &[windowName, isVisible] : config.windowVisibility) {
-		if (allWindowSet.count(windowName)) {
-			setWindowVisible(windowName, isVisible);
+		auto entity = getWindowEntity(windowName);
+		if (entity != entt::null) {
+			setWindowVisible(entity, isVisible);
 			spdlog::info("[Workspace] Set '{}' visible={}", windowName,
 						 isVisible);
 		} else {
@@ -554,10 +779,11 @@ MWindow::captureCurrentUIState(const std::string &workspaceName) {
 	config.name = workspaceName;
 	config.description =
 		"Custom workspace created on " + std::to_string(std::time(nullptr));
-	std::vector<std::string> allWindows = getAllWindowNames();
-	spdlog::info("Found {} windows:", allWindows.size());
-	for (const auto &windowName : allWindows) {
-		bool isVisible = isWindowVisible(windowName);
+	auto view = m_registry.view<ecs::CWindow>();
+	spdlog::info("Found {} windows:", view.size());
+	for (auto entity : view) {
+		const auto &windowName = view.get<ecs::CWindow>(entity).name;
+		bool isVisible = isWindowVisible(entity);
 		if (!isVisible) {
 			config.windowVisibility[windowName] = false;
 			spdlog::info("  - {} : hidden (captured)", windowName);
@@ -641,6 +867,48 @@ bool MWindow::getWindowVisibility(const std::string &windowName) const {
 			   : true;
 }
 
+void MWindow::setWindowPosition(const std::string &windowName, float x,
+								float y) {
+	auto entity = getWindowEntity(windowName);
+	if (!isValidWindow(entity))
+		return;
+	m_registry.patch<ecs::CWindowTransform>(
+		entity, [x, y](ecs::CWindowTransform &transform) {
+			transform.position.x = x;
+			transform.position.y = y;
+		});
+}
+
+void MWindow::setWindowSize(const std::string &windowName, float width,
+							float height) {
+	auto entity = getWindowEntity(windowName);
+	if (!isValidWindow(entity))
+		return;
+	m_registry.patch<ecs::CWindowTransform>(
+		entity, [width, height](ecs::CWindowTransform &transform) {
+			transform.size.x = width;
+			transform.size.y = height;
+		});
+}
+
+std::pair<float, float>
+MWindow::getWindowPosition(const std::string &windowName) const {
+	auto entity = getWindowEntity(windowName);
+	if (!isValidWindow(entity))
+		return {0.0f, 0.0f};
+	const auto &transform = m_registry.get<ecs::CWindowTransform>(entity);
+	return {transform.position.x, transform.position.y};
+}
+
+std::pair<float, float>
+MWindow::getWindowSize(const std::string &windowName) const {
+	auto entity = getWindowEntity(windowName);
+	if (!isValidWindow(entity))
+		return {0.0f, 0.0f};
+	const auto &transform = m_registry.get<ecs::CWindowTransform>(entity);
+	return {transform.size.x, transform.size.y};
+}
+
 void MWindow::saveCurrentImGuiLayout() {
 	ImGui::SaveIniSettingsToDisk(m_mainIniPath.c_str());
 }
@@ -5,11 +5,34 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "FrameProfiler.h"
 #include "Window.h"
 #include "core/ISettings.h"
 
+struct ImGuiWindow;
+
 namespace blot {
 
+// Render-side companion of ecs::CWindow. Owns the Window so the render loop
+// reaches it straight from the component pool, without hash lookups or
+// shared_ptr copies.
+struct CWindowInstance {
+	std::shared_ptr<Window> window;
+	// Set when CWindowTransform/CWindowStyle changed and must be pushed into
+	// the Window before it is rendered next
+	bool dirty = true;
+	// Skipped this frame because an opaque window fully covers it
+	bool culled = false;
+	// The window covering it when culled; checked again after the frame's
+	// windows are submitted
+	const ::ImGuiWindow *occluder = nullptr;
+	// Cached ImGui window ID (hash of the title), resolved on first use
+	ImGuiID imguiId = 0;
+	// Frame profiler track for this window's render() time
+	FrameProfiler::TrackId profilerTrack = FrameProfiler::kInvalidTrack;
+	bool profilerResolved = false;
+};
+
 struct WorkspaceConfig {
 	std::string name;
 	std::string description;
@@ -28,8 +51,11 @@ class MWindow : public ISettings {
 	void destroyWindow(entt::entity windowEntity);
 	void destroyWindow(const std::string &windowName);
 
-	// Window queries
-	entt::entity getWindowEntity(const std::string &name);
+	// Window queries. getWindowEntity() is an O(1) lookup in the name index;
+	// callers on hot paths should resolve the entity once and use the
+	// entity-based overloads below instead of passing names every frame.
+	entt::entity getWindowEntity(const std::string &name) const;
+	bool isValidWindow(entt::entity e) const;
 	std::shared_ptr<Window> getWindow(const std::string &name);
 	std::shared_ptr<Window> getWindow(entt::entity e);
 	std::shared_ptr<Window> getWindow(entt::entity e) const;
@@ -53,16 +79,41 @@ class MWindow : public ISettings {
 
 	// Window operations
 	void showWindow(const std::string &name);
+	void showWindow(entt::entity e);
 	void hideWindow(const std::string &name);
+	void hideWindow(entt::entity e);
 	void closeWindow(const std::string &name);
 	void focusWindow(const std::string &name);
+	void focusWindow(entt::entity e);
 	void closeFocusedWindow();
 	void closeAllWindows();
 
+	// Per-window update rate (see Window::UpdatePolicy)
+	void setWindowUpdatePolicy(const std::string &name,
+							   Window::UpdatePolicy policy,
+							   float rateHz = 10.0f);
+	void setWindowUpdatePolicy(entt::entity e, Window::UpdatePolicy policy,
+							   float rateHz = 10.0f);
+	void invalidateWindow(entt::entity e);
+	void invalidateAllWindows();
+
+	// Z-order: windows render back to front by CWindow::zOrder. Focusing a
+	// window raises it; the CWindow pool is re-sorted only after such changes.
+	void bringToFront(entt::entity e);
+
+	// Optional occlusion culling: floating (undocked) windows fully covered by
+	// an opaque floating window above them are not submitted for the frame
+	void setOcclusionCulling(bool enabled);
+	bool isOcclusionCullingEnabled() const { return m_occlusionCulling; }
+	size_t getCulledWindowCount() const { return m_culledWindowCount; }
+
 	// Window visibility management
 	bool isWindowVisible(const std::string &name);
+	bool isWindowVisible(entt::entity e) const;
 	void setWindowVisible(const std::string &name, bool visible);
+	void setWindowVisible(entt::entity e, bool visible);
 	void toggleWindow(const std::string &name);
+	void toggleWindow(entt::entity e);
 	void showAllWindows();
 	void hideAllWindows(const std::vector<std::string> &except = {
 							"MainMenuBar"});
@@ -82,6 +133,10 @@ class MWindow : public ISettings {
 	void handleInput();
 	void update();
 
+	// Redraw requests raised by windows (see Window::requestRedraw)
+	bool hasRedrawRequests() const;
+	bool consumeRedrawRequests();
+
 	// Workspace management (moved from WorkspaceManager)
 	bool loadWorkspace(const std::string &workspaceName);
 	bool saveWorkspace(const std::string &workspaceName);
@@ -99,6 +154,10 @@ class MWindow : public ISettings {
 	void setWindowPosition(const std::string &windowName, float x, float y);
 	void setWindowSize(const std::string &windowName, float width,
 					   float height);
+	// Flag a window whose CWindowTransform/CWindowStyle was modified in place.
+	// Changes made through registry.patch()/replace() are tracked
+	// automatically.
+	void markWindowDirty(entt::entity e);
 	std::pair<float, float>
 	getWindowPosition(const std::string &windowName) const;
 	std::pair<float, float> getWindowSize(const std::string &windowName) const;
@@ -106,6 +165,10 @@ class MWindow : public ISettings {
 	void loadImGuiLayout(const std::string &layoutData);
 	std::string getCurrentImGuiLayout() const;
 
+	// Per-window render timings are recorded here when set
+	void setFrameProfiler(FrameProfiler *profiler) { m_profiler = profiler; }
+	FrameProfiler *getFrameProfiler() const { return m_profiler; }
+
 	// Registry access
 	entt::registry &getRegistry() { return m_registry; }
 	const entt::registry &getRegistry() const { return m_registry; }
@@ -117,7 +180,18 @@ class MWindow : public ISettings {
 	entt::registry m_registry;
 	entt::entity m_focusedWindowEntity = entt::null;
 
+	FrameProfiler *m_profiler = nullptr;
+
+	// Z-order and occlusion state
+	int m_nextZOrder = 0;
+	bool m_zOrderDirty = false;
+	bool m_occlusionCulling = false;
+	size_t m_culledWindowCount = 0;
+	std::vector<::ImGuiWindow *> m_occluders;
+	void cullOccludedWindows();
+
 	void updateFocus();
+	void onWindowComponentUpdated(entt::registry &registry, entt::entity e);
 	void handleEscapeKey();
 	void sortWindowsByZOrder();
 
@@ -139,7 +213,8 @@ class MWindow : public ISettings {
 	createWorkspaceFromCurrentState(const std::string &workspaceName);
 	void updateMainIniFile();
 
-	std::unordered_map<entt::entity, std::shared_ptr<Window>> m_windowMap;
+	// Name -> entity index, kept in sync by createWindow/destroyWindow
+	std::unordered_map<std::string, entt::entity> m_nameIndex;
 };
 
 } // namespace blot
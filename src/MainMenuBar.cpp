@@ -23,8 +23,6 @@ void MainMenuBar::setEventSystem(ecs::SEvent *eventSystem) {
 }
 
 bool MainMenuBar::hasAction(const std::string &actionId) const {
-	std::cout << "[MainMenuBar] hasAction called, m_eventSystem ptr: "
-			  << m_eventSystem << std::endl;
 	return m_eventSystem ? m_eventSystem->hasAction(actionId) : false;
 }
 
@@ -178,10 +176,6 @@ void MainMenuBar::render() {
 		}
 
 		// Workspace menu
-		std::cout << "[MainMenuBar] hasAction(get_available_workspaces): "
-				  << hasAction("get_available_workspaces") << std::endl;
-		std::cout << "[MainMenuBar] hasAction(load_workspace): "
-				  << hasAction("load_workspace") << std::endl;
 		if (ImGui::BeginMenu("Workspace")) {
 			// Load submenu
 			if (ImGui::BeginMenu("Load")) {
@@ -0,0 +1,68 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace blot {
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string &path) {
+	auto file = std::make_shared<MappedFile>();
+#ifdef _WIN32
+	HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ,
+								FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+								OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return nullptr;
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(handle, &size) && size.QuadPart > 0) {
+		HANDLE mapping =
+			CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) {
+			file->m_data = static_cast<const char *>(
+				MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(mapping);
+		}
+		file->m_size = static_cast<size_t>(size.QuadPart);
+	}
+	CloseHandle(handle);
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+	struct stat info;
+	if (fstat(fd, &info) == 0 && info.st_size > 0) {
+		void *data = mmap(nullptr, static_cast<size_t>(info.st_size),
+						  PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			file->m_data = static_cast<const char *>(data);
+			file->m_size = static_cast<size_t>(info.st_size);
+		}
+	}
+	::close(fd);
+#endif
+	return file->m_data ? file : nullptr;
+}
+
+MappedFile::~MappedFile() {
+	if (!m_data)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(m_data);
+#else
+	munmap(const_cast<char *>(m_data), m_size);
+#endif
+}
+
+} // namespace blot
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace blot {
+
+// Read-only mapping of a whole file
+class MappedFile {
+  public:
+	// nullptr when the file is missing, empty or cannot be mapped
+	static std::shared_ptr<MappedFile> open(const std::string &path);
+
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	const char *data() const { return m_data; }
+	size_t size() const { return m_size; }
+
+  private:
+	const char *m_data = nullptr;
+	size_t m_size = 0;
+};
+
+} // namespace blot
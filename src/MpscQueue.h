@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace blot {
+
+// Bounded lock-free multi-producer / single-consumer queue (Vyukov's
+// sequence-numbered ring). Producers never block: tryPush() fails when the
+// ring is full and the caller decides what to drop. Only one thread may call
+// tryPop().
+template <typename T> class MpscQueue {
+  public:
+	explicit MpscQueue(size_t capacity) {
+		size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+		m_mask = size - 1;
+		m_slots.reset(new Slot[size]);
+		for (size_t i = 0; i < size; i++)
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	MpscQueue(const MpscQueue &) = delete;
+	MpscQueue &operator=(const MpscQueue &) = delete;
+
+	size_t capacity() const { return m_mask + 1; }
+
+	bool tryPush(T &&value) {
+		size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+		Slot *slot;
+		while (true) {
+			slot = &m_slots[pos & m_mask];
+			size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			intptr_t diff =
+				static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+			if (diff == 0) {
+				if (m_enqueuePos.compare_exchange_weak(
+						pos, pos + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				return false; // full
+			} else {
+				pos = m_enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		slot->value = std::move(value);
+		slot->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool tryPop(T &value) {
+		Slot *slot = &m_slots[m_dequeuePos & m_mask];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		if (sequence != m_dequeuePos + 1)
+			return false; // empty (or the producer is still writing)
+		value = std::move(slot->value);
+		slot->sequence.store(m_dequeuePos + m_mask + 1,
+							 std::memory_order_release);
+		++m_dequeuePos;
+		return true;
+	}
+
+  private:
+	struct Slot {
+		std::atomic<size_t> sequence{0};
+		T value{};
+	};
+
+	std::unique_ptr<Slot[]> m_slots;
+	size_t m_mask = 0;
+	// Producers and the consumer touch different cache lines
+	alignas(64) std::atomic<size_t> m_enqueuePos{0};
+	alignas(64) size_t m_dequeuePos = 0;
+};
+
+} // namespace blot
@@ -1,14 +1,23 @@
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
 #include <imgui.h>
+#include <imgui_internal.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 #include <iostream>
+#include <mutex>
 #include <set>
 #include <spdlog/spdlog.h>
 #include "../assets/fonts/fontRobotoRegular.h"
 #include "../third_party/IconFontCppHeaders/IconsFontAwesome5.h"
+#ifdef BXIMGUI_ICON_SUBSET
+#include "bxImGuiIcons.h" // generated by cmake/IconSubset.cmake
+#endif
+#include "AllocationCounter.h"
+#include "ImGuiAllocator.h"
 #include "ImGuiRenderer.h"
 #include "MWindow.h"
 #include "MainMenuBar.h"
@@ -18,54 +27,46 @@
 #include "core/json.h"
 #include "core/addon/WinAddons.h"
 #include "core/canvas/CanvasWindow.h"
+#include "core/util/AppPaths.h"
+#include "DebugPanel.h"
 #include "InfoWindow.h"
 #include "LogWindow.h"
+#include "NotificationHistoryWindow.h"
 #include "PropertiesWindow.h"
 #include "SaveWorkspaceDialog.h"
+#include "TerminalWindow.h"
 #include "TextureViewerWindow.h"
 #include "ThemeEditorWindow.h"
 #include "ThemePanel.h"
 #include "ToolbarWindow.h"
 #include "WindowManagerPanel.h"
+#ifdef BXIMGUI_HAS_IMPLOT
+#include <implot.h>
+#endif
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
 #endif
 
 namespace blot {
-// Helper for icon and color
-static const char *getIconForType(NotificationType type) {
-	switch (type) {
-	case NotificationType::Info:
-		return ICON_FA_INFO_CIRCLE;
-	case NotificationType::Success:
-		return ICON_FA_CHECK_CIRCLE;
-	case NotificationType::Warning:
-		return ICON_FA_EXCLAMATION_TRIANGLE;
-	case NotificationType::Error:
-		return ICON_FA_TIMES_CIRCLE;
-	default:
-		return ICON_FA_INFO_CIRCLE;
-	}
-}
-static ImVec4 getColorForType(NotificationType type) {
-	switch (type) {
-	case NotificationType::Info:
-		return ImVec4(0.2f, 0.6f, 1.0f, 1.0f);
-	case NotificationType::Success:
-		return ImVec4(0.2f, 0.8f, 0.2f, 1.0f);
-	case NotificationType::Warning:
-		return ImVec4(1.0f, 0.7f, 0.2f, 1.0f);
-	case NotificationType::Error:
-		return ImVec4(1.0f, 0.2f, 0.2f, 1.0f);
-	default:
-		return ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
-	}
-}
-
-Mui::Mui(GLFWwindow *window) : m_window(window) {
+
+Mui::Mui(GLFWwindow *window, Backend backend)
+	: m_window(window), m_backend(backend) {
 	// Create window manager
 	m_windowManager = std::make_unique<MWindow>();
+	m_windowManager->setFrameProfiler(&m_frameProfiler);
+	// Window-scoped shortcuts follow MWindow's focused entity
+	m_shortcutManager.setWindowManager(m_windowManager.get());
+
+	const std::filesystem::path cacheDirectory =
+		std::filesystem::path(AppPaths::getImGuiIniPath()).parent_path() /
+		"cache";
+	m_fontCache.setDirectory((cacheDirectory / "fonts").string());
+	m_logSpillDirectory = (cacheDirectory / "logs").string();
 
 	// Remove WorkspaceManager construction and setup
 	m_currentTheme = ImGuiTheme::Light;
@@ -83,11 +84,23 @@ void Mui::init() { initImGui(); }
 
 void Mui::initImGui() {
 	IMGUI_CHECKVERSION();
+	// Pooled allocator for ImGui's heap traffic; it also feeds
+	// AllocationCounter so steady frames can be checked for allocations
+	ImGuiAllocator::instance().install();
 	ImGui::CreateContext();
+#ifdef BXIMGUI_HAS_IMPLOT
+	// DebugPanel plots frame timings; reuse the app's context if it has one
+	if (!ImPlot::GetCurrentContext()) {
+		m_implotContext = ImPlot::CreateContext();
+	}
+#endif
 	ImGuiIO &io = ImGui::GetIO();
 	io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
 	io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
-	io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+	// Multi-viewport needs a platform backend to create OS windows
+	if (!isHeadless()) {
+		io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+	}
 
 	// Set up ImGui style (Light theme)
 	ImGui::StyleColorsLight();
@@ -114,50 +127,279 @@ void Mui::initImGui() {
 	// Load FontAwesome Solid font and merge
 	float baseFontSize = 16.0f * uiScale;
 	float iconFontSize = baseFontSize * 2.0f / 3.0f;
+#ifdef BXIMGUI_ICON_SUBSET
+	// Only the icons the sources use, collected at build time
+	const ImWchar *icons_ranges = kIconGlyphRanges;
+#else
 	static const ImWchar icons_ranges[] = {ICON_MIN_FA, ICON_MAX_16_FA, 0};
+#endif
 	ImFontConfig icons_config;
 	icons_config.MergeMode = true;
 	icons_config.PixelSnapH = true;
 	icons_config.GlyphMinAdvanceX = iconFontSize;
+#ifdef BXIMGUI_EMBEDDED_ICON_FONT
+	icons_config.FontDataOwnedByAtlas = false;
+	io.Fonts->AddFontFromMemoryTTF(const_cast<unsigned char *>(kIconFontData),
+								   sizeof(kIconFontData), iconFontSize,
+								   &icons_config, icons_ranges);
+#else
 	io.Fonts->AddFontFromFileTTF("assets/fonts/fa-solid-900.ttf", iconFontSize,
 								 &icons_config, icons_ranges);
-
-	// Initialize ImGui with GLFW and OpenGL
-	ImGui_ImplGlfw_InitForOpenGL(m_window, true);
-	ImGui_ImplOpenGL3_Init("#version 330");
+#endif
+	// Bake now, from the disk cache when fonts and scale are unchanged; the
+	// backends then find the atlas built
+	m_fontCache.build(io.Fonts, uiScale);
+
+	if (isHeadless()) {
+		// No platform/renderer: take the atlas texture on the CPU so
+		// NewFrame() can run, and keep build machines free of stray
+		// imgui.ini files
+		io.BackendPlatformName = "bxImGui_Headless";
+		io.BackendRendererName = "bxImGui_Null";
+		io.IniFilename = nullptr;
+		io.DisplaySize = m_headlessDisplaySize;
+		unsigned char *pixels = nullptr;
+		int width = 0, height = 0;
+		io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+	} else {
+		// Initialize ImGui with GLFW and OpenGL
+		ImGui_ImplGlfw_InitForOpenGL(m_window, true);
+		ImGui_ImplOpenGL3_Init("#version 330");
+	}
 
 	// Initialize enhanced text renderer
 	m_imguiRenderer = std::make_unique<ImGuiRenderer>();
+	m_imguiRenderer->setFontCache(&m_fontCache);
+	// Glyphs finish on a worker; wake an idle loop to show them
+	m_imguiRenderer->getGlyphLoader().setReadyCallback(
+		[this]() { wakeFrameLoop(); });
 }
 
 void Mui::shutdown() { shutdownImGui(); }
 
 void Mui::shutdownImGui() {
+	// shutdown() and the destructor both land here; only tear down once
+	if (!ImGui::GetCurrentContext())
+		return;
 	// Shutdown ImGui implementation
-	ImGui_ImplOpenGL3_Shutdown();
-	ImGui_ImplGlfw_Shutdown();
+	if (!isHeadless()) {
+		ImGui_ImplOpenGL3_Shutdown();
+		ImGui_ImplGlfw_Shutdown();
+	}
+#ifdef BXIMGUI_HAS_IMPLOT
+	if (m_implotContext) {
+		ImPlot::DestroyContext(m_implotContext);
+		m_implotContext = nullptr;
+	}
+#endif
 	ImGui::DestroyContext();
 }
 
+// Frames kept alive after input or a redraw request so hover states,
+// popups and window appearance settle before idling again
+static constexpr int kIdleSettleFrames = 3;
+
 void Mui::update() {
 	spdlog::debug("[Mui] update() called");
-	// Start ImGui frame
-	ImGui_ImplOpenGL3_NewFrame();
-	ImGui_ImplGlfw_NewFrame();
-	ImGui::NewFrame();
+	const bool replaying = isReplayingInput();
+	const bool idle = m_idleMode && !replaying;
+	if (idle && !isHeadless() && !hasPendingWork()) {
+		// Sleep until GLFW has something for us (or the timeout elapses)
+		glfwWaitEventsTimeout(m_idleTimeout);
+	}
+	// After the wait: a post during it wakes GLFW with an empty event
+	drainUiCommands();
+
+	beginFrame();
+
+	if (idle) {
+		if (hasPendingInput()) {
+			m_settleFrames = kIdleSettleFrames;
+		}
+		if (!hasPendingWork()) {
+			skipFrame();
+			return;
+		}
+		bool redraw = m_redrawRequested.exchange(false);
+		if (m_windowManager && m_windowManager->consumeRedrawRequests()) {
+			redraw = true;
+		}
+		if (redraw) {
+			m_settleFrames = kIdleSettleFrames;
+		}
+		// Time spent idling still counts for animations and toast timers
+		ImGui::GetIO().DeltaTime += m_skippedDeltaTime;
+		m_skippedDeltaTime = 0.0f;
+	}
+
+	if (m_inputRecorder) {
+		// Before NewFrame(), which consumes the queued events
+		m_inputRecorder->recordFrame(*ImGui::GetCurrentContext());
+	}
+
+	if (m_imguiRenderer) {
+		// Glyphs loaded since the last frame join the atlas before NewFrame().
+		// The texture may have been recreated and glyph UVs rescaled, so
+		// replayed snapshots would draw stale texels.
+		if (m_imguiRenderer->updateGlyphs() && m_windowManager) {
+			m_windowManager->invalidateAllWindows();
+		}
+	}
+
+	AllocationCounter::beginFrame();
+	const auto frameStart = std::chrono::steady_clock::now();
+	{
+		FrameProfiler::Scope frameScope(&m_frameProfiler,
+										FrameProfiler::Phase::Frame);
+		{
+			FrameProfiler::Scope scope(&m_frameProfiler,
+									   FrameProfiler::Phase::NewFrame);
+			ImGui::NewFrame();
+		}
+		if (m_imguiRenderer) {
+			m_imguiRenderer->collectFrameText();
+		}
+		buildFrame();
+		endFrame();
+	}
+	const auto frameEnd = std::chrono::steady_clock::now();
+	AllocationCounter::endFrame();
+	if (replaying) {
+		m_inputReplayer->recordResult(
+			std::chrono::duration<double, std::milli>(frameEnd - frameStart)
+				.count(),
+			ImGui::GetDrawData());
+	}
+	AllocationCounter::Counts allocations =
+		AllocationCounter::lastFrameCounts();
+	m_frameStats.lastFrameAllocations = allocations.allocations;
+	m_frameStats.lastFrameAllocatedBytes = allocations.bytes;
+	if (allocations.allocations > 0) {
+		++m_frameStats.allocatingFrames;
+	}
 
+	m_lastDisplaySize = ImGui::GetIO().DisplaySize;
+	if (m_settleFrames > 0) {
+		--m_settleFrames;
+	}
+	++m_frameStats.framesBuilt;
+}
+
+void Mui::beginFrame() {
+	// Start backend frame; ImGui::NewFrame() is issued by update()
+	if (isHeadless()) {
+		ImGuiIO &io = ImGui::GetIO();
+		io.DisplaySize = m_headlessDisplaySize;
+		io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
+		io.DeltaTime = m_headlessDeltaTime;
+		if (isReplayingInput()) {
+			m_inputReplayer->applyNextFrame(io, m_replayDeltaTime);
+		}
+	} else {
+		ImGui_ImplOpenGL3_NewFrame();
+		ImGui_ImplGlfw_NewFrame();
+	}
+}
+
+bool Mui::startInputRecording(const std::string &path) {
+	m_inputRecorder = std::make_unique<InputRecorder>();
+	if (!m_inputRecorder->open(path)) {
+		spdlog::error("[Mui] {}", m_inputRecorder->getError());
+		m_inputRecorder.reset();
+		return false;
+	}
+	return true;
+}
+
+void Mui::stopInputRecording() {
+	if (!m_inputRecorder)
+		return;
+	m_inputRecorder->close();
+	if (!m_inputRecorder->getError().empty()) {
+		spdlog::error("[Mui] {}", m_inputRecorder->getError());
+	}
+	m_inputRecorder.reset();
+}
+
+bool Mui::startInputReplay(const std::string &path, float fixedDeltaTime) {
+	if (!isHeadless()) {
+		// Live GLFW input would interleave with the recorded events
+		spdlog::error("[Mui] Input replay needs the headless backend");
+		return false;
+	}
+	m_inputReplayer = std::make_unique<InputReplayer>();
+	if (!m_inputReplayer->load(path)) {
+		spdlog::error("[Mui] {}", m_inputReplayer->getError());
+		m_inputReplayer.reset();
+		return false;
+	}
+	m_replayDeltaTime = fixedDeltaTime;
+	return true;
+}
+
+bool Mui::runInputReplay(const std::string &path, InputReplayReport &report,
+						 float fixedDeltaTime) {
+	if (!startInputReplay(path, fixedDeltaTime))
+		return false;
+	while (isReplayingInput()) {
+		update();
+	}
+	report = m_inputReplayer->getReport();
+	return true;
+}
+
+bool Mui::hasPendingWork() const {
+	if (m_settleFrames > 0 || m_frameStats.framesBuilt == 0)
+		return true;
+	if (m_redrawRequested.load(std::memory_order_relaxed))
+		return true;
+	if (!m_notifications.empty() || !m_modals.empty())
+		return true;
+	if (m_windowManager && m_windowManager->hasRedrawRequests())
+		return true;
+	return false;
+}
+
+bool Mui::hasPendingInput() const {
+	ImGuiContext &g = *ImGui::GetCurrentContext();
+	if (g.InputEventsQueue.Size > 0)
+		return true;
+	// Ongoing interaction (drag, text cursor blink, held buttons)
+	if (g.ActiveId != 0 || ImGui::IsAnyMouseDown())
+		return true;
+	const ImVec2 &size = g.IO.DisplaySize;
+	return size.x != m_lastDisplaySize.x || size.y != m_lastDisplaySize.y;
+}
+
+void Mui::skipFrame() {
+	m_skippedDeltaTime += ImGui::GetIO().DeltaTime;
+	++m_frameStats.framesSkipped;
+	if (isHeadless())
+		return;
+	// Draw data stays valid until the next NewFrame(); present it again so
+	// the engine's clear/swap does not blank the UI. Secondary viewports keep
+	// their last presented image.
+	if (ImDrawData *drawData = ImGui::GetDrawData()) {
+		ImGui_ImplOpenGL3_RenderDrawData(drawData);
+	}
+}
+
+void Mui::buildFrame() {
 	// Load workspace on first frame only
-	static bool workspaceLoaded = false;
-	if (!workspaceLoaded) {
+	if (!m_workspaceLoaded) {
 		loadWorkspace("current");
-		workspaceLoaded = true;
+		m_workspaceLoaded = true;
 	}
 
 	// Simple dockspace setup
-	setupDockspace();
+	{
+		FrameProfiler::Scope scope(&m_frameProfiler,
+								   FrameProfiler::Phase::Dockspace);
+		setupDockspace();
+	}
 
 	// Show debug menu bar
-	if (m_blotEngine->getDebugMode()) {
+	if (m_blotEngine && m_blotEngine->getDebugMode()) {
 		if (ImGui::BeginMainMenuBar()) {
 			if (ImGui::BeginMenu("Debug")) {
 				if (ImGui::MenuItem("Exit Debug Mode")) {
@@ -184,7 +426,8 @@ void Mui::update() {
 
 	// Handle debug mode toggle with F12 key (using GLFW directly)
 	static bool f12Pressed = false;
-	if (glfwGetKey(glfwGetCurrentContext(), GLFW_KEY_F12) == GLFW_PRESS) {
+	if (!isHeadless() && m_blotEngine &&
+		glfwGetKey(glfwGetCurrentContext(), GLFW_KEY_F12) == GLFW_PRESS) {
 		if (!f12Pressed) {
 			m_blotEngine->setDebugMode(!m_blotEngine->getDebugMode());
 			f12Pressed = true;
@@ -192,9 +435,24 @@ void Mui::update() {
 	} else {
 		f12Pressed = false;
 	}
+}
 
+void Mui::endFrame() {
 	// Render ImGui frame
-	ImGui::Render();
+	{
+		FrameProfiler::Scope scope(&m_frameProfiler,
+								   FrameProfiler::Phase::ImGuiRender);
+		ImGui::Render();
+	}
+	if (m_drawDataCallback) {
+		m_drawDataCallback(ImGui::GetDrawData());
+	}
+	if (isHeadless()) {
+		// Null renderer: the draw data is discarded
+		return;
+	}
+	FrameProfiler::Scope scope(&m_frameProfiler,
+							   FrameProfiler::Phase::RenderDrawData);
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
 	// Update and render additional viewports
@@ -240,6 +498,8 @@ void Mui::setupDockspace() {
 	// Render the main menu bar inside the dockspace window
 	if (ImGui::BeginMenuBar()) {
 		if (m_mainMenuBar && !m_bHideMainMenuBar) {
+			FrameProfiler::Scope scope(&m_frameProfiler,
+									   FrameProfiler::Phase::MenuBar);
 			m_mainMenuBar->render();
 		}
 		ImGui::EndMenuBar();
@@ -257,45 +517,24 @@ void Mui::renderAllWindows() {
 
 	// Render all windows
 	if (m_windowManager) {
+		FrameProfiler::Scope scope(&m_frameProfiler,
+								   FrameProfiler::Phase::Windows);
 		if (m_bHideWindows) {
-			for (const auto &name : m_windowManager->getAllWindowNames()) {
-				m_windowManager->setWindowVisible(name, false);
-			}
+			m_windowManager->hideAllWindows({});
 		}
 		m_windowManager->renderAllWindows();
 	}
-	// Render notifications (toasts)
-	float y = 20.0f;
-	float x = ImGui::GetIO().DisplaySize.x - 350.0f;
-	for (auto &n : m_notifications) {
-		ImGui::SetNextWindowPos(ImVec2(x, y), ImGuiCond_Always);
-		ImGui::SetNextWindowBgAlpha(0.85f);
-		ImGui::PushStyleColor(ImGuiCol_Text, getColorForType(n.type));
-		ImGui::Begin(
-			(std::string("##toast") + std::to_string(&n - &m_notifications[0]))
-				.c_str(),
-			nullptr,
-			ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
-				ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoFocusOnAppearing |
-				ImGuiWindowFlags_NoInputs);
-		ImGui::Text("%s  %s", getIconForType(n.type), n.message.c_str());
-		ImGui::End();
-		ImGui::PopStyleColor();
-		y += 48.0f;
-		n.timeRemaining -= ImGui::GetIO().DeltaTime;
-	}
-	m_notifications.erase(std::remove_if(m_notifications.begin(),
-										 m_notifications.end(),
-										 [](const Notification &n) {
-											 return n.timeRemaining <= 0;
-										 }),
-						  m_notifications.end());
-	// Before loading workspace, print all registered window names
-	auto allWindows = m_windowManager->getAllWindowNames();
-	spdlog::info("Registered windows: {}", allWindows.size());
-	for (const auto &w : allWindows)
-		spdlog::info("{}", w);
-	spdlog::info("");
+
+	FrameProfiler::Scope scope(&m_frameProfiler,
+							   FrameProfiler::Phase::Notifications);
+	renderNotifications();
+}
+
+void Mui::renderNotifications() {
+	// Toasts: one pass into the foreground draw list, no windows
+	m_notifications.update(ImGui::GetIO().DeltaTime);
+	m_notifications.render(ImGui::GetForegroundDrawList(),
+						   ImGui::GetIO().DisplaySize);
 	// Render modals (blocking popups)
 	if (!m_modals.empty()) {
 		Modal &m = m_modals.front();
@@ -308,8 +547,8 @@ void Mui::renderAllWindows() {
 								 ImGuiCond_Appearing);
 		if (ImGui::BeginPopupModal(m.title.c_str(), nullptr,
 								   ImGuiWindowFlags_NoScrollbar)) {
-			ImGui::TextColored(getColorForType(m.type), "%s",
-							   getIconForType(m.type));
+			ImGui::TextColored(getNotificationColor(m.type), "%s",
+							   getNotificationIcon(m.type));
 			ImGui::SameLine();
 			// Scrollable message area, fixed height
 			float buttonAreaHeight = 50.0f;
@@ -347,6 +586,56 @@ void Mui::renderAllWindows() {
 	}
 }
 
+static unsigned long currentProcessId() {
+#ifdef _WIN32
+	return GetCurrentProcessId();
+#else
+	return static_cast<unsigned long>(getpid());
+#endif
+}
+
+static bool isProcessRunning(unsigned long pid) {
+#ifdef _WIN32
+	HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE,
+								 static_cast<DWORD>(pid));
+	if (!process)
+		return GetLastError() == ERROR_ACCESS_DENIED;
+	DWORD exitCode = 0;
+	const bool running =
+		GetExitCodeProcess(process, &exitCode) && exitCode == STILL_ACTIVE;
+	CloseHandle(process);
+	return running;
+#else
+	// EPERM: it exists, owned by someone else
+	return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+// This process' spill directory under root. Session directories of
+// processes that are gone (a crash skips LogSpill's cleanup) are removed;
+// those of running instances are left alone.
+static std::string logSpillSessionDirectory(const std::string &root) {
+	namespace fs = std::filesystem;
+	const std::string prefix = "session-";
+	const unsigned long self = currentProcessId();
+	std::error_code error;
+	for (const auto &entry : fs::directory_iterator(root, error)) {
+		const std::string name = entry.path().filename().string();
+		std::error_code entryError;
+		if (name.compare(0, prefix.size(), prefix) != 0 ||
+			!entry.is_directory(entryError))
+			continue;
+		const std::string digits = name.substr(prefix.size());
+		if (digits.empty() || digits.size() > 9 ||
+			digits.find_first_not_of("0123456789") != std::string::npos)
+			continue;
+		const unsigned long pid = std::stoul(digits);
+		if (pid != self && !isProcessRunning(pid))
+			fs::remove_all(entry.path(), entryError);
+	}
+	return (fs::path(root) / (prefix + std::to_string(self))).string();
+}
+
 void Mui::setupWindows(BlotEngine *app) {
 	if (!m_windowManager)
 		return;
@@ -372,8 +661,9 @@ void Mui::setupWindows(BlotEngine *app) {
 		Window::Flags::NoScrollbar | Window::Flags::NoCollapse);
 	m_windowManager->createWindow(canvasWindow->getTitle(), canvasWindow);
 
-	// Create info window
+	// Create info window (read-only readout, refreshed at 10 Hz when idle)
 	auto infoWindow = std::make_shared<InfoWindow>();
+	infoWindow->setUpdatePolicy(Window::UpdatePolicy::Throttled, 10.0f);
 	m_windowManager->createWindow(infoWindow->getTitle(), infoWindow);
 
 	// Create properties window
@@ -391,7 +681,7 @@ void Mui::setupWindows(BlotEngine *app) {
 	auto addonManagerWindow = std::make_shared<WinAddons>(
 		"Addon Manager###MAddon", Window::Flags::None);
 	// Set the central MAddon pointer
-	if (m_blotEngine->getAddonManager()) {
+	if (m_blotEngine && m_blotEngine->getAddonManager()) {
 		addonManagerWindow->setAddonManager(m_blotEngine->getAddonManager());
 	}
 	m_windowManager->createWindow(addonManagerWindow->getTitle(),
@@ -408,6 +698,13 @@ void Mui::setupWindows(BlotEngine *app) {
 	auto logWindow = std::make_shared<blot::LogWindow>("Log###LogWindow",
 													   Window::Flags::None);
 	m_windowManager->createWindow(logWindow->getTitle(), logWindow);
+	// Lines logged by other threads show without waiting out the idle sleep
+	logWindow->setWakeCallback([this]() { wakeFrameLoop(); });
+	// Only a few chunks stay in memory; the session's scrollback is on disk
+	if (!m_logSpillDirectory.empty()) {
+		logWindow->setSpillDirectory(
+			logSpillSessionDirectory(m_logSpillDirectory));
+	}
 	logWindow->setupSpdlogSink();
 
 	// Initialize save workspace dialog before registering
@@ -419,9 +716,29 @@ void Mui::setupWindows(BlotEngine *app) {
 	m_windowManager->createWindow(saveWorkspaceDialog->getTitle(),
 								  saveWorkspaceDialog);
 
+	// Register notification history (toasts keep only the recent ones)
+	auto notificationHistory = std::make_shared<NotificationHistoryWindow>();
+	notificationHistory->setNotificationCenter(&m_notifications);
+	m_windowManager->createWindow(notificationHistory->getTitle(),
+								  notificationHistory);
+
+	// Register debug panel (frame profiler readout)
+	auto debugPanel = std::make_shared<DebugPanel>();
+	debugPanel->setFrameProfiler(&m_frameProfiler);
+	m_windowManager->createWindow(debugPanel->getTitle(), debugPanel);
+
+	// Register terminal (hidden until opened from the Window Manager)
+	auto terminalWindow = std::make_shared<TerminalWindow>();
+	registerCommands(terminalWindow->getCommands());
+	m_windowManager->setWindowVisible(
+		m_windowManager->createWindow(terminalWindow->getTitle(),
+									  terminalWindow),
+		false);
+
 	// Register Window Manager panel
 	auto windowManagerPanel = std::make_shared<WindowManagerPanel>(
 		"Window Manager", m_windowManager.get(), Window::Flags::None);
+	windowManagerPanel->setUpdatePolicy(Window::UpdatePolicy::Throttled, 4.0f);
 	m_windowManager->createWindow(windowManagerPanel->getTitle(),
 								  windowManagerPanel);
 }
@@ -487,6 +804,9 @@ void Mui::setImGuiTheme(ImGuiTheme theme) {
 	}
 	}
 	m_currentTheme = theme;
+	if (m_windowManager) {
+		m_windowManager->invalidateAllWindows();
+	}
 }
 
 void Mui::saveCurrentTheme(const std::string &path) {
@@ -702,8 +1022,225 @@ void Mui::saveCurrentImGuiLayout() {
 
 void Mui::showNotification(const std::string &message, NotificationType type,
 						   float duration) {
-	m_notifications.push_back({message, type, duration});
+	m_notifications.push(message, type, duration);
+}
+bool Mui::postUiCommand(UiCommand &&command) {
+	if (!m_uiCommands.tryPush(std::move(command))) {
+		m_droppedUiCommands.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	wakeFrameLoop();
+	return true;
 }
+
+void Mui::wakeFrameLoop() {
+	// glfwPostEmptyEvent() is thread-safe
+	m_redrawRequested.store(true, std::memory_order_relaxed);
+	if (!isHeadless()) {
+		glfwPostEmptyEvent();
+	}
+}
+
+bool Mui::postNotification(std::string message, NotificationType type,
+						   float duration) {
+	UiCommand command;
+	command.type = UiCommand::Type::Notification;
+	command.text = std::move(message);
+	command.notificationType = type;
+	command.duration = duration;
+	return postUiCommand(std::move(command));
+}
+
+bool Mui::postWindowVisibility(std::string windowName, bool visible) {
+	UiCommand command;
+	command.type = UiCommand::Type::WindowVisibility;
+	command.text = std::move(windowName);
+	command.visible = visible;
+	return postUiCommand(std::move(command));
+}
+
+bool Mui::postWindowVisibilityAll(bool visible) {
+	UiCommand command;
+	command.type = UiCommand::Type::WindowVisibilityAll;
+	command.visible = visible;
+	return postUiCommand(std::move(command));
+}
+
+bool Mui::post(std::function<void(Mui &)> closure) {
+	if (!closure)
+		return false;
+	UiCommand command;
+	command.type = UiCommand::Type::Closure;
+	command.closure = std::move(closure);
+	return postUiCommand(std::move(command));
+}
+
+namespace {
+
+// The window registry as ecs-stats saw it, copied on the UI thread
+struct EcsStatsSnapshot {
+	struct Row {
+		std::string name;
+		int zOrder = 0;
+		bool visible = false;
+		bool focused = false;
+		bool culled = false;
+		Window::UpdatePolicy policy = Window::UpdatePolicy::EveryFrame;
+	};
+	size_t windows = 0;
+	size_t transforms = 0;
+	size_t styles = 0;
+	size_t inputs = 0;
+	size_t instances = 0;
+	size_t culled = 0;
+	bool occlusionCulling = false;
+	std::vector<Row> rows;
+};
+
+const char *updatePolicyName(Window::UpdatePolicy policy) {
+	switch (policy) {
+	case Window::UpdatePolicy::Throttled:
+		return "throttled";
+	case Window::UpdatePolicy::Static:
+		return "static";
+	case Window::UpdatePolicy::EveryFrame:
+		break;
+	}
+	return "every frame";
+}
+
+} // namespace
+
+void Mui::registerCommands(CommandRegistry &commands) {
+	// Runs on the terminal's worker: the registry is copied by a UI command,
+	// then sorted and printed off the UI thread, stopping on Ctrl+C
+	Command ecsStats;
+	ecsStats.name = "ecs-stats";
+	ecsStats.description = "Show window registry pools and per-window state";
+	ecsStats.args = {{"filter", CommandArg::Type::Rest, true,
+					  "Only windows whose name contains this"}};
+	ecsStats.execution = Command::Execution::Async;
+	ecsStats.handler = [this](CommandContext &ctx) {
+		struct Request {
+			std::mutex mutex;
+			std::condition_variable done;
+			bool ready = false;
+			EcsStatsSnapshot snapshot;
+		};
+		auto request = std::make_shared<Request>();
+		const bool posted = post([request](Mui &mui) {
+			EcsStatsSnapshot snapshot;
+			if (MWindow *windows = mui.getWindowManager()) {
+				const entt::registry &registry = windows->getRegistry();
+				snapshot.windows = registry.view<ecs::CWindow>().size();
+				snapshot.transforms =
+					registry.view<ecs::CWindowTransform>().size();
+				snapshot.styles = registry.view<ecs::CWindowStyle>().size();
+				snapshot.inputs = registry.view<ecs::CWindowInput>().size();
+				snapshot.instances = registry.view<CWindowInstance>().size();
+				snapshot.culled = windows->getCulledWindowCount();
+				snapshot.occlusionCulling = windows->isOcclusionCullingEnabled();
+				auto view = registry.view<ecs::CWindow, CWindowInstance>();
+				for (auto entity : view) {
+					const auto &window = view.get<ecs::CWindow>(entity);
+					const auto &instance = view.get<CWindowInstance>(entity);
+					EcsStatsSnapshot::Row row;
+					row.name = window.name;
+					row.zOrder = window.zOrder;
+					row.visible = window.isVisible;
+					row.focused = window.isFocused;
+					row.culled = instance.culled;
+					if (instance.window)
+						row.policy = instance.window->getUpdatePolicy();
+					snapshot.rows.push_back(std::move(row));
+				}
+			}
+			std::lock_guard<std::mutex> lock(request->mutex);
+			request->snapshot = std::move(snapshot);
+			request->ready = true;
+			request->done.notify_one();
+		});
+		if (!posted) {
+			ctx.error("UI command queue is full; try again");
+			return;
+		}
+		EcsStatsSnapshot snapshot;
+		{
+			// Polled so Ctrl+C works while the UI loop is busy or idle
+			std::unique_lock<std::mutex> lock(request->mutex);
+			while (!request->ready) {
+				request->done.wait_for(lock, std::chrono::milliseconds(50));
+				if (!request->ready && ctx.isCancelled())
+					return;
+			}
+			snapshot = std::move(request->snapshot);
+		}
+
+		ctx.print("Window registry: " + std::to_string(snapshot.windows) +
+				  " windows");
+		ctx.print("  CWindow " + std::to_string(snapshot.windows) +
+				  ", CWindowTransform " + std::to_string(snapshot.transforms) +
+				  ", CWindowStyle " + std::to_string(snapshot.styles) +
+				  ", CWindowInput " + std::to_string(snapshot.inputs) +
+				  ", CWindowInstance " + std::to_string(snapshot.instances));
+		ctx.print(std::string("  occlusion culling ") +
+				  (snapshot.occlusionCulling ? "on" : "off") + ", " +
+				  std::to_string(snapshot.culled) + " culled");
+
+		// Top-most first
+		std::sort(snapshot.rows.begin(), snapshot.rows.end(),
+				  [](const EcsStatsSnapshot::Row &lhs,
+					 const EcsStatsSnapshot::Row &rhs) {
+					  return lhs.zOrder > rhs.zOrder;
+				  });
+		const std::string &filter = ctx.arg(0);
+		for (const EcsStatsSnapshot::Row &row : snapshot.rows) {
+			if (ctx.isCancelled())
+				return;
+			if (!filter.empty() && row.name.find(filter) == std::string::npos)
+				continue;
+			std::string line = "  " + std::to_string(row.zOrder) + " " +
+							   row.name + " - " +
+							   updatePolicyName(row.policy);
+			if (!row.visible)
+				line += ", hidden";
+			if (row.focused)
+				line += ", focused";
+			if (row.culled)
+				line += ", culled";
+			ctx.print(std::move(line));
+		}
+	};
+	std::string error;
+	if (!commands.add(std::move(ecsStats), &error))
+		spdlog::warn("[Mui] Cannot register ecs-stats: {}", error);
+}
+
+void Mui::drainUiCommands() {
+	UiCommand &command = m_uiCommandScratch;
+	while (m_uiCommands.tryPop(command)) {
+		switch (command.type) {
+		case UiCommand::Type::Notification:
+			m_notifications.push(command.text, command.notificationType,
+								 command.duration);
+			break;
+		case UiCommand::Type::WindowVisibility:
+			setWindowVisibility(command.text, command.visible);
+			break;
+		case UiCommand::Type::WindowVisibilityAll:
+			setWindowVisibilityAll(command.visible);
+			break;
+		case UiCommand::Type::Closure:
+			command.closure(*this);
+			break;
+		case UiCommand::Type::None:
+			break;
+		}
+		// Release captures now rather than when the scratch is reused
+		command.closure = nullptr;
+	}
+}
+
 void Mui::showModal(const std::string &title, const std::string &message,
 					NotificationType type, std::function<void()> onOk) {
 	m_modals.push_back({title, message, type, onOk, true});
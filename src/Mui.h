@@ -1,16 +1,24 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <deque>
 #include <entt/entt.hpp>
 #include <functional>
+#include <imgui.h>
 #include <memory>
 #include <string>
 #include <vector>
 #include "../third_party/IconFontCppHeaders/IconsFontAwesome5.h"
 #include "CoordinateSystem.h"
+#include "FontAtlasCache.h"
+#include "FrameProfiler.h"
 #include "ImGuiRenderer.h"
+#include "InputRecording.h"
 #include "MShortcut.h"
 #include "MWindow.h"
+#include "MpscQueue.h"
+#include "Notifications.h"
 #include "U_ui.h"
 #include "core/BlotEngine.h"
 #include "core/ISettings.h"
@@ -27,7 +35,9 @@
 
 // Forward declarations
 struct GLFWwindow;
+struct ImPlotContext;
 namespace blot {
+class CommandRegistry;
 class MainMenuBar;
 class SaveWorkspaceDialog;
 class Window;
@@ -35,15 +45,6 @@ class Window;
 
 namespace blot {
 
-// Notification types
-enum class NotificationType { Info, Success, Warning, Error };
-
-struct Notification {
-	std::string message;
-	NotificationType type;
-	float timeRemaining;
-};
-
 struct Modal {
 	std::string title;
 	std::string message;
@@ -54,7 +55,17 @@ struct Modal {
 
 class Mui : public Iui {
   public:
-	Mui(GLFWwindow *window);
+	// Platform/renderer backend driving the ImGui frame. Headless runs
+	// NewFrame/Render with a synthetic display and timestep and never touches
+	// GLFW or OpenGL, so the UI can be exercised on machines without a GPU.
+	enum class Backend { GlfwOpenGL3, Headless };
+#ifdef BXIMGUI_HEADLESS
+	static constexpr Backend kDefaultBackend = Backend::Headless;
+#else
+	static constexpr Backend kDefaultBackend = Backend::GlfwOpenGL3;
+#endif
+
+	Mui(GLFWwindow *window, Backend backend = kDefaultBackend);
 	~Mui();
 
 	void init() override;
@@ -69,6 +80,88 @@ class Mui : public Iui {
 	void initImGui();
 	void shutdownImGui();
 
+	// Backend selection and headless frame parameters
+	Backend getBackend() const { return m_backend; }
+	bool isHeadless() const { return m_backend == Backend::Headless; }
+	void setHeadlessDisplaySize(float width, float height) {
+		m_headlessDisplaySize = ImVec2(width, height);
+	}
+	void setHeadlessDeltaTime(float deltaTime) {
+		m_headlessDeltaTime = deltaTime;
+	}
+	// Directory for the baked font atlas cache (see FontAtlasCache); set
+	// before init(). Empty disables it. Defaults to cache/fonts next to the
+	// ImGui ini file.
+	void setFontCacheDirectory(const std::string &directory) {
+		m_fontCache.setDirectory(directory);
+	}
+	FontAtlasCache &getFontAtlasCache() { return m_fontCache; }
+	// Root for the log window's spill segments; set before setupWindows().
+	// Each process spills into its own session-<pid> subdirectory, removed
+	// on exit. Empty keeps the log in memory only. Defaults to cache/logs
+	// next to the ImGui ini file.
+	void setLogSpillDirectory(const std::string &directory) {
+		m_logSpillDirectory = directory;
+	}
+	// Called with the frame's ImDrawData right after ImGui::Render(), in both
+	// backends. The data is only valid for the duration of the call.
+	void setDrawDataCallback(std::function<void(ImDrawData *)> callback) {
+		m_drawDataCallback = std::move(callback);
+	}
+
+	// Input recording: every frame's ImGuiIO input (events, display size,
+	// delta time) is appended to a binary stream at path until stopped
+	bool startInputRecording(const std::string &path);
+	void stopInputRecording();
+	bool isRecordingInput() const {
+		return m_inputRecorder && m_inputRecorder->isOpen();
+	}
+	// Replay (headless backend only): following update() calls feed the
+	// recording's frames into ImGui, with fixedDeltaTime per frame (<= 0
+	// keeps the recorded one), timing each frame and hashing its draw data.
+	// Idle mode is bypassed while replaying.
+	bool startInputReplay(const std::string &path,
+						  float fixedDeltaTime = 1.0f / 60.0f);
+	bool isReplayingInput() const {
+		return m_inputReplayer && !m_inputReplayer->isFinished();
+	}
+	// Runs a whole replay; false if it cannot start
+	bool runInputReplay(const std::string &path, InputReplayReport &report,
+						float fixedDeltaTime = 1.0f / 60.0f);
+	const InputReplayReport *getInputReplayReport() const {
+		return m_inputReplayer ? &m_inputReplayer->getReport() : nullptr;
+	}
+
+	// Idle mode: when enabled, update() only builds a new ImGui frame if
+	// input arrived, toasts/modals are pending, or a redraw was requested.
+	// Otherwise the previous draw data is presented again and the GLFW
+	// backend blocks in glfwWaitEventsTimeout() for up to idleTimeout seconds.
+	struct FrameStats {
+		uint64_t framesBuilt = 0;
+		uint64_t framesSkipped = 0;
+		// Heap allocations made by the last built frame (see
+		// AllocationCounter) and how many built frames allocated at all
+		uint64_t lastFrameAllocations = 0;
+		uint64_t lastFrameAllocatedBytes = 0;
+		uint64_t allocatingFrames = 0;
+	};
+	void setIdleMode(bool enabled) { m_idleMode = enabled; }
+	bool isIdleMode() const { return m_idleMode; }
+	void setIdleTimeout(double seconds) { m_idleTimeout = seconds; }
+	double getIdleTimeout() const { return m_idleTimeout; }
+	// Safe to call from any thread
+	void requestRedraw() {
+		m_redrawRequested.store(true, std::memory_order_relaxed);
+	}
+	// requestRedraw() plus an empty GLFW event, so a loop sleeping in idle
+	// mode runs its next frame now; safe to call from any thread
+	void wakeFrameLoop();
+	const FrameStats &getFrameStats() const { return m_frameStats; }
+
+	// Per-phase and per-window CPU timings (shown in DebugPanel)
+	FrameProfiler &getFrameProfiler() { return m_frameProfiler; }
+	void resetFrameStats() { m_frameStats = FrameStats{}; }
+
 	// Window management
 	void setupDockspace();
 	void renderAllWindows();
@@ -76,7 +169,7 @@ class Mui : public Iui {
 	void setupWindows(BlotEngine *engine);
 	void setupWindowCallbacks(BlotEngine *engine);
 
-	// Window visibility management
+	// Window visibility management (UI thread; see postWindowVisibility)
 	void setWindowVisibility(const std::string &windowName, bool visible);
 	void setWindowVisibilityAll(bool visible);
 	bool getWindowVisibility(const std::string &windowName) const;
@@ -142,7 +235,7 @@ class Mui : public Iui {
 
 	MainMenuBar *getMainMenuBar() { return m_mainMenuBar.get(); }
 
-	// Notification/Popup API
+	// Notification/Popup API (UI thread; see postNotification)
 	void showNotification(const std::string &message,
 						  NotificationType type = NotificationType::Info,
 						  float duration = 3.0f);
@@ -150,6 +243,25 @@ class Mui : public Iui {
 				   NotificationType type = NotificationType::Info,
 				   std::function<void()> onOk = nullptr);
 
+	// Posting from any thread: commands go through a lock-free queue and
+	// are applied at the start of the next update(), on the UI thread.
+	// Notifications and visibility changes are queued as plain data; post()
+	// takes any closure. A full queue drops the command and returns false.
+	bool postNotification(std::string message,
+						  NotificationType type = NotificationType::Info,
+						  float duration = 3.0f);
+	bool postWindowVisibility(std::string windowName, bool visible);
+	bool postWindowVisibilityAll(bool visible);
+	bool post(std::function<void(Mui &)> command);
+
+	// Adds Mui's console commands (ecs-stats) to a terminal's registry; the
+	// registry must not outlive this Mui. setupWindows() does this for the
+	// terminal it creates.
+	void registerCommands(CommandRegistry &commands);
+	uint64_t getDroppedUiCommandCount() const {
+		return m_droppedUiCommands.load(std::memory_order_relaxed);
+	}
+
 	void setBlotEngine(BlotEngine *engine) { m_blotEngine = engine; }
 
 	CoordinateSystem &getCoordinateSystem() { return m_coordinateSystem; }
@@ -166,9 +278,62 @@ class Mui : public Iui {
 	void registerUIActions(blot::ecs::SEvent &) override;
 
   private:
-	// GLFW window reference
+	// GLFW window reference (unused by the headless backend)
 	GLFWwindow *m_window;
 
+	// Backend state
+	Backend m_backend = kDefaultBackend;
+	ImVec2 m_headlessDisplaySize = ImVec2(1280.0f, 720.0f);
+	float m_headlessDeltaTime = 1.0f / 60.0f;
+	std::function<void(ImDrawData *)> m_drawDataCallback;
+	bool m_workspaceLoaded = false;
+
+	// Idle mode state
+	bool m_idleMode = false;
+	double m_idleTimeout = 0.5;
+	std::atomic<bool> m_redrawRequested{true};
+	int m_settleFrames = 0;
+	float m_skippedDeltaTime = 0.0f;
+	ImVec2 m_lastDisplaySize = ImVec2(0.0f, 0.0f);
+	FrameStats m_frameStats;
+	FrameProfiler m_frameProfiler;
+	std::unique_ptr<InputRecorder> m_inputRecorder;
+	std::unique_ptr<InputReplayer> m_inputReplayer;
+	float m_replayDeltaTime = 1.0f / 60.0f;
+	ImPlotContext *m_implotContext = nullptr;
+
+	// Commands posted from other threads
+	struct UiCommand {
+		enum class Type : uint8_t {
+			None,
+			Notification,
+			WindowVisibility,
+			WindowVisibilityAll,
+			Closure
+		};
+		Type type = Type::None;
+		NotificationType notificationType = NotificationType::Info;
+		bool visible = false;
+		float duration = 0.0f;
+		std::string text; // message or window name
+		std::function<void(Mui &)> closure;
+	};
+	static constexpr size_t kUiCommandCapacity = 1024;
+	MpscQueue<UiCommand> m_uiCommands{kUiCommandCapacity};
+	std::atomic<uint64_t> m_droppedUiCommands{0};
+	UiCommand m_uiCommandScratch;
+	bool postUiCommand(UiCommand &&command);
+	void drainUiCommands();
+
+	// Frame phases driven by update()
+	void beginFrame();
+	void buildFrame();
+	void endFrame();
+	void renderNotifications();
+	bool hasPendingWork() const;
+	bool hasPendingInput() const;
+	void skipFrame();
+
 	// Core window manager
 	std::unique_ptr<MWindow> m_windowManager;
 
@@ -185,12 +350,14 @@ class Mui : public Iui {
 
 	// ImGui with enhanced text rendering
 	std::unique_ptr<ImGuiRenderer> m_imguiRenderer;
+	FontAtlasCache m_fontCache;
+	std::string m_logSpillDirectory;
 
 	// Setup methods
 	void configureWindowSettings();
 	std::unique_ptr<MainMenuBar> m_mainMenuBar;
 
-	std::deque<Notification> m_notifications;
+	NotificationCenter m_notifications;
 	std::deque<Modal> m_modals;
 
 	BlotEngine *m_blotEngine = nullptr;
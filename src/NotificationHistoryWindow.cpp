@@ -0,0 +1,80 @@
+#include "NotificationHistoryWindow.h"
+#include <cstring>
+#include <ctime>
+
+namespace blot {
+
+static void formatClock(std::time_t time, char *out, size_t size) {
+	std::tm local = {};
+#ifdef _WIN32
+	localtime_s(&local, &time);
+#else
+	localtime_r(&time, &local);
+#endif
+	std::strftime(out, size, "%H:%M:%S", &local);
+}
+
+NotificationHistoryWindow::NotificationHistoryWindow(const std::string &title,
+													 Flags flags)
+	: Window(title, flags) {}
+
+void NotificationHistoryWindow::renderContents() {
+	if (!m_center) {
+		ImGui::TextDisabled("No notification center");
+		return;
+	}
+	const auto &history = m_center->getHistory();
+	ImGui::Text("%zu entries", history.size());
+	if (m_center->getEvictedCount() > 0) {
+		ImGui::SameLine();
+		ImGui::TextDisabled("(%llu toasts evicted)",
+							static_cast<unsigned long long>(
+								m_center->getEvictedCount()));
+	}
+	ImGui::SameLine();
+	if (ImGui::SmallButton("Clear")) {
+		m_center->clearHistory();
+	}
+	ImGui::Separator();
+
+	ImGui::BeginChild("History", ImVec2(0, 0), false);
+	const int count = static_cast<int>(history.size());
+	char timeText[16];
+	ImGuiListClipper clipper;
+	clipper.Begin(count);
+	while (clipper.Step()) {
+		for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+			const NotificationCenter::HistoryEntry &entry =
+				history[static_cast<size_t>(count - 1 - row)];
+			formatClock(entry.lastTime, timeText, sizeof(timeText));
+			ImGui::TextDisabled("%s", timeText);
+			ImGui::SameLine();
+			const ImVec4 color = getNotificationColor(entry.type);
+			ImGui::TextColored(color, "%s", getNotificationIcon(entry.type));
+			ImGui::SameLine();
+			if (entry.count > 1) {
+				ImGui::TextColored(color, "x%u", entry.count);
+				ImGui::SameLine();
+			}
+			// First line only: the clipper relies on a fixed row height
+			const char *text = entry.message.c_str();
+			const char *lineEnd = std::strchr(text, '\n');
+			ImGui::TextUnformatted(text, lineEnd);
+			if ((entry.count > 1 || lineEnd) && ImGui::IsItemHovered()) {
+				ImGui::BeginTooltip();
+				if (entry.count > 1) {
+					char firstText[16];
+					formatClock(entry.firstTime, firstText, sizeof(firstText));
+					ImGui::Text("%u times, %s - %s", entry.count, firstText,
+								timeText);
+				}
+				if (lineEnd)
+					ImGui::TextUnformatted(text);
+				ImGui::EndTooltip();
+			}
+		}
+	}
+	ImGui::EndChild();
+}
+
+} // namespace blot
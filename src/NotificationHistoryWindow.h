@@ -0,0 +1,27 @@
+#pragma once
+
+#include <imgui.h>
+#include "Notifications.h"
+#include "Window.h"
+
+namespace blot {
+
+// Every notification shown so far, newest first. Rows are clipped, so the
+// window costs the same with ten entries or thousands.
+class NotificationHistoryWindow : public Window {
+  public:
+	NotificationHistoryWindow(
+		const std::string &title = "Notifications###NotificationHistory",
+		Flags flags = Flags::None);
+	virtual ~NotificationHistoryWindow() = default;
+
+	void setNotificationCenter(NotificationCenter *center) {
+		m_center = center;
+	}
+	void renderContents() override;
+
+  private:
+	NotificationCenter *m_center = nullptr;
+};
+
+} // namespace blot
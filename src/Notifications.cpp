@@ -0,0 +1,184 @@
+#include "Notifications.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "../third_party/IconFontCppHeaders/IconsFontAwesome5.h"
+
+namespace blot {
+
+const char *getNotificationIcon(NotificationType type) {
+	switch (type) {
+	case NotificationType::Info:
+		return ICON_FA_INFO_CIRCLE;
+	case NotificationType::Success:
+		return ICON_FA_CHECK_CIRCLE;
+	case NotificationType::Warning:
+		return ICON_FA_EXCLAMATION_TRIANGLE;
+	case NotificationType::Error:
+		return ICON_FA_TIMES_CIRCLE;
+	default:
+		return ICON_FA_INFO_CIRCLE;
+	}
+}
+
+ImVec4 getNotificationColor(NotificationType type) {
+	switch (type) {
+	case NotificationType::Info:
+		return ImVec4(0.2f, 0.6f, 1.0f, 1.0f);
+	case NotificationType::Success:
+		return ImVec4(0.2f, 0.8f, 0.2f, 1.0f);
+	case NotificationType::Warning:
+		return ImVec4(1.0f, 0.7f, 0.2f, 1.0f);
+	case NotificationType::Error:
+		return ImVec4(1.0f, 0.2f, 0.2f, 1.0f);
+	default:
+		return ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+	}
+}
+
+static uint32_t hashMessage(const char *text, size_t length) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= static_cast<unsigned char>(text[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Toast layout, in pixels
+static constexpr float kToastWidth = 330.0f;
+static constexpr float kToastMargin = 20.0f;
+static constexpr float kToastPadding = 10.0f;
+static constexpr float kToastSpacing = 8.0f;
+static constexpr float kToastFadeTime = 0.3f;
+
+void NotificationCenter::push(const std::string &message,
+							  NotificationType type, float duration) {
+	addHistory(message, type);
+
+	const uint32_t length = static_cast<uint32_t>(
+		(std::min)(message.size(), kMaxMessage - 1));
+	const uint32_t hash = hashMessage(message.data(), length);
+	for (size_t i = 0; i < m_toastCount; i++) {
+		Toast &toast = m_toasts[i];
+		if (toast.hash == hash && toast.type == type &&
+			toast.length == length &&
+			std::memcmp(toast.message, message.data(), length) == 0) {
+			toast.count++;
+			toast.duration = (std::max)(toast.duration, duration);
+			toast.timeRemaining = (std::max)(toast.timeRemaining, duration);
+			return;
+		}
+	}
+
+	if (m_toastCount == kMaxToasts) {
+		std::move(m_toasts + 1, m_toasts + kMaxToasts, m_toasts);
+		m_toastCount--;
+		m_evicted++;
+	}
+	Toast &toast = m_toasts[m_toastCount++];
+	std::memcpy(toast.message, message.data(), length);
+	toast.message[length] = '\0';
+	toast.length = length;
+	toast.hash = hash;
+	toast.type = type;
+	toast.count = 1;
+	toast.duration = duration;
+	toast.timeRemaining = duration;
+	toast.layoutFontSize = 0.0f;
+}
+
+void NotificationCenter::addHistory(const std::string &message,
+									NotificationType type) {
+	const std::time_t now = std::time(nullptr);
+	if (!m_history.empty()) {
+		HistoryEntry &last = m_history.back();
+		if (last.type == type && last.message == message) {
+			last.count++;
+			last.lastTime = now;
+			return;
+		}
+	}
+	if (m_history.size() == kMaxHistory)
+		m_history.pop_front();
+	m_history.push_back({message, type, 1, now, now});
+}
+
+void NotificationCenter::update(float deltaTime) {
+	for (size_t i = 0; i < m_toastCount; i++)
+		m_toasts[i].timeRemaining -= deltaTime;
+	Toast *end = std::remove_if(
+		m_toasts, m_toasts + m_toastCount,
+		[](const Toast &toast) { return toast.timeRemaining <= 0.0f; });
+	m_toastCount = static_cast<size_t>(end - m_toasts);
+}
+
+void NotificationCenter::render(ImDrawList *drawList,
+								const ImVec2 &displaySize) {
+	if (m_toastCount == 0)
+		return;
+	ImFont *font = ImGui::GetFont();
+	const float fontSize = ImGui::GetFontSize();
+	const ImGuiStyle &style = ImGui::GetStyle();
+	const float iconWidth =
+		ImGui::CalcTextSize(getNotificationIcon(NotificationType::Warning)).x +
+		kToastPadding;
+	const float badgeWidth = ImGui::CalcTextSize("x9999+").x + kToastPadding;
+	const float wrapWidth =
+		kToastWidth - 2.0f * kToastPadding - iconWidth - badgeWidth;
+
+	const float x = displaySize.x - kToastWidth - kToastMargin;
+	float y = kToastMargin;
+	char badge[16];
+	for (size_t i = 0; i < m_toastCount; i++) {
+		Toast &toast = m_toasts[i];
+		if (toast.layoutFontSize != fontSize) {
+			toast.textSize = ImGui::CalcTextSize(
+				toast.message, toast.message + toast.length, false, wrapWidth);
+			toast.layoutFontSize = fontSize;
+		}
+		const float height =
+			(std::max)(toast.textSize.y, fontSize) + 2.0f * kToastPadding;
+		if (y + height > displaySize.y - kToastMargin) {
+			// No room for the rest: say how many are waiting
+			std::snprintf(badge, sizeof(badge), "+%zu more", m_toastCount - i);
+			drawList->AddText(ImVec2(x + kToastPadding, y),
+							  ImGui::GetColorU32(ImGuiCol_Text), badge);
+			break;
+		}
+
+		const float alpha =
+			(std::min)(toast.timeRemaining / kToastFadeTime, 1.0f);
+		ImVec4 color = getNotificationColor(toast.type);
+		color.w *= alpha;
+		const ImU32 textColor = ImGui::ColorConvertFloat4ToU32(color);
+		const ImVec2 min(x, y);
+		const ImVec2 max(x + kToastWidth, y + height);
+		drawList->AddRectFilled(
+			min, max, ImGui::GetColorU32(ImGuiCol_WindowBg, 0.85f * alpha),
+			style.WindowRounding);
+		drawList->AddRect(min, max,
+						  ImGui::GetColorU32(ImGuiCol_Border, alpha),
+						  style.WindowRounding);
+		const ImVec2 textPos(x + kToastPadding, y + kToastPadding);
+		drawList->AddText(textPos, textColor,
+						  getNotificationIcon(toast.type));
+		drawList->AddText(font, fontSize,
+						  ImVec2(textPos.x + iconWidth, textPos.y), textColor,
+						  toast.message, toast.message + toast.length,
+						  wrapWidth);
+		if (toast.count > 1) {
+			if (toast.count > 9999)
+				std::snprintf(badge, sizeof(badge), "x9999+");
+			else
+				std::snprintf(badge, sizeof(badge), "x%u", toast.count);
+			const float width = ImGui::CalcTextSize(badge).x;
+			drawList->AddText(
+				ImVec2(max.x - kToastPadding - width, textPos.y),
+				ImGui::GetColorU32(ImGuiCol_Text, alpha), badge);
+		}
+		y = max.y + kToastSpacing;
+	}
+}
+
+} // namespace blot
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <imgui.h>
+#include <string>
+
+namespace blot {
+
+// Notification types
+enum class NotificationType { Info, Success, Warning, Error };
+
+const char *getNotificationIcon(NotificationType type);
+ImVec4 getNotificationColor(NotificationType type);
+
+// Toasts and their history. Active toasts live in a fixed pool, copied into
+// fixed-size slots so a burst never allocates; a message equal to an active
+// toast (same type and text) bumps that toast's count and timer instead of
+// adding one, and a full pool evicts its oldest toast. All toasts are drawn
+// into the foreground draw list, so they create no ImGui windows. The
+// history keeps every message (consecutive repeats coalesced) up to a cap.
+// UI thread only; other threads go through Mui::postNotification().
+class NotificationCenter {
+  public:
+	static constexpr size_t kMaxToasts = 32;
+	static constexpr size_t kMaxMessage = 256; // bytes kept per toast
+	static constexpr size_t kMaxHistory = 4096;
+
+	struct HistoryEntry {
+		std::string message;
+		NotificationType type = NotificationType::Info;
+		uint32_t count = 1;
+		std::time_t firstTime = 0;
+		std::time_t lastTime = 0;
+	};
+
+	void push(const std::string &message, NotificationType type,
+			  float duration);
+	// Ages toasts by deltaTime and drops expired ones
+	void update(float deltaTime);
+	void render(ImDrawList *drawList, const ImVec2 &displaySize);
+
+	bool empty() const { return m_toastCount == 0; }
+	size_t size() const { return m_toastCount; }
+	uint64_t getEvictedCount() const { return m_evicted; }
+
+	const std::deque<HistoryEntry> &getHistory() const { return m_history; }
+	void clearHistory() { m_history.clear(); }
+
+  private:
+	struct Toast {
+		char message[kMaxMessage];
+		uint32_t length = 0;
+		uint32_t hash = 0;
+		NotificationType type = NotificationType::Info;
+		uint32_t count = 0;
+		float timeRemaining = 0.0f;
+		float duration = 0.0f;
+		// Wrapped text size, recomputed when the font size changes
+		ImVec2 textSize = ImVec2(0.0f, 0.0f);
+		float layoutFontSize = 0.0f;
+	};
+
+	void addHistory(const std::string &message, NotificationType type);
+
+	// Oldest first
+	Toast m_toasts[kMaxToasts];
+	size_t m_toastCount = 0;
+	uint64_t m_evicted = 0;
+	std::deque<HistoryEntry> m_history;
+};
+
+} // namespace blot
@@ -156,11 +156,13 @@ void PropertiesWindow::renderVector2Editor(const char *label, float &x,
 										   float &y) {
 	ImGui::Text("%s:", label);
 	ImGui::SameLine();
+	ImGui::PushID(label);
 	ImGui::PushItemWidth(60);
-	ImGui::DragFloat(("##" + std::string(label) + "X").c_str(), &x, 0.1f);
+	ImGui::DragFloat("##X", &x, 0.1f);
 	ImGui::SameLine();
-	ImGui::DragFloat(("##" + std::string(label) + "Y").c_str(), &y, 0.1f);
+	ImGui::DragFloat("##Y", &y, 0.1f);
 	ImGui::PopItemWidth();
+	ImGui::PopID();
 }
 
 void PropertiesWindow::renderFloatEditor(const char *label, float &value,
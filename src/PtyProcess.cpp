@@ -0,0 +1,207 @@
+#include "PtyProcess.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <util.h>
+#elif defined(__FreeBSD__)
+#include <libutil.h>
+#else
+#include <pty.h>
+#endif
+#endif
+
+namespace blot {
+
+PtyProcess::~PtyProcess() { stop(); }
+
+#ifdef _WIN32
+
+bool PtyProcess::start(const std::string &, int, int, OutputCallback,
+					   std::function<void()>) {
+	m_error = "Pseudo terminals are not supported on this platform";
+	return false;
+}
+
+void PtyProcess::stop() {}
+void PtyProcess::write(const char *, size_t) {}
+void PtyProcess::resize(int, int) {}
+void PtyProcess::readerLoop() {}
+void PtyProcess::wake() {}
+
+#else
+
+static constexpr size_t kReadSize = 64 * 1024;
+
+bool PtyProcess::start(const std::string &command, int cols, int rows,
+					   OutputCallback onOutput, std::function<void()> onExit) {
+	stop();
+	m_error.clear();
+	if (pipe(m_wakePipe) != 0) {
+		m_error = "pipe() failed";
+		return false;
+	}
+	for (int fd : m_wakePipe)
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+	struct winsize size = {};
+	size.ws_col = static_cast<unsigned short>(std::max(cols, 1));
+	size.ws_row = static_cast<unsigned short>(std::max(rows, 1));
+	const char *shell = std::getenv("SHELL");
+	if (!shell || !*shell)
+		shell = "/bin/sh";
+
+	pid_t pid = forkpty(&m_master, nullptr, nullptr, &size);
+	if (pid < 0) {
+		m_error = "forkpty() failed";
+		close(m_wakePipe[0]);
+		close(m_wakePipe[1]);
+		m_wakePipe[0] = m_wakePipe[1] = -1;
+		return false;
+	}
+	if (pid == 0) {
+		setenv("TERM", "xterm-256color", 1);
+		if (command.empty()) {
+			execl(shell, shell, static_cast<char *>(nullptr));
+		} else {
+			execl("/bin/sh", "sh", "-c", command.c_str(),
+				  static_cast<char *>(nullptr));
+		}
+		_exit(127);
+	}
+
+	fcntl(m_master, F_SETFL, fcntl(m_master, F_GETFL) | O_NONBLOCK);
+	m_pid = pid;
+	m_onOutput = std::move(onOutput);
+	m_onExit = std::move(onExit);
+	m_stop = false;
+	m_exitStatus = -1;
+	m_running = true;
+	m_reader = std::thread([this]() { readerLoop(); });
+	return true;
+}
+
+void PtyProcess::stop() {
+	if (m_reader.joinable()) {
+		m_stop = true;
+		wake();
+		m_reader.join();
+	}
+	if (m_pid > 0) {
+		// Give the child a moment to exit on SIGHUP before killing it
+		kill(m_pid, SIGHUP);
+		int status = 0;
+		pid_t result = 0;
+		for (int i = 0; i < 20 && result == 0; i++) {
+			result = waitpid(m_pid, &status, WNOHANG);
+			if (result == 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		if (result == 0) {
+			kill(m_pid, SIGKILL);
+			waitpid(m_pid, &status, 0);
+		}
+		m_pid = -1;
+	}
+	for (int *fd : {&m_master, &m_wakePipe[0], &m_wakePipe[1]}) {
+		if (*fd >= 0) {
+			close(*fd);
+			*fd = -1;
+		}
+	}
+	m_running = false;
+	std::lock_guard<std::mutex> lock(m_inputMutex);
+	m_input.clear();
+}
+
+void PtyProcess::wake() {
+	if (m_wakePipe[1] >= 0) {
+		char byte = 1;
+		[[maybe_unused]] ssize_t written = ::write(m_wakePipe[1], &byte, 1);
+	}
+}
+
+void PtyProcess::write(const char *data, size_t size) {
+	if (!m_running || size == 0)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(m_inputMutex);
+		m_input.append(data, size);
+	}
+	wake();
+}
+
+void PtyProcess::resize(int cols, int rows) {
+	if (m_master < 0)
+		return;
+	struct winsize size = {};
+	size.ws_col = static_cast<unsigned short>(std::max(cols, 1));
+	size.ws_row = static_cast<unsigned short>(std::max(rows, 1));
+	ioctl(m_master, TIOCSWINSZ, &size);
+}
+
+void PtyProcess::readerLoop() {
+	std::unique_ptr<char[]> buffer(new char[kReadSize]);
+	std::string pending; // input taken from m_input, not yet written
+	while (!m_stop) {
+		if (pending.empty()) {
+			std::lock_guard<std::mutex> lock(m_inputMutex);
+			pending.swap(m_input);
+		}
+		pollfd fds[2] = {};
+		fds[0].fd = m_master;
+		fds[0].events = POLLIN | (pending.empty() ? 0 : POLLOUT);
+		fds[1].fd = m_wakePipe[0];
+		fds[1].events = POLLIN;
+		if (poll(fds, 2, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		if (fds[1].revents & POLLIN) {
+			char drain[64];
+			while (read(m_wakePipe[0], drain, sizeof(drain)) > 0) {
+			}
+		}
+		if (fds[0].revents & POLLOUT) {
+			ssize_t written = ::write(m_master, pending.data(), pending.size());
+			if (written > 0)
+				pending.erase(0, static_cast<size_t>(written));
+		}
+		if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+			ssize_t count = read(m_master, buffer.get(), kReadSize);
+			if (count > 0) {
+				m_onOutput(buffer.get(), static_cast<size_t>(count));
+			} else if (count == 0 ||
+					   (errno != EAGAIN && errno != EINTR)) {
+				// EIO: the child closed its side
+				break;
+			}
+		}
+	}
+	if (!m_stop) {
+		int status = 0;
+		// A child that closed the tty but keeps running is reaped by stop()
+		if (m_pid > 0 && waitpid(m_pid, &status, WNOHANG) == m_pid) {
+			m_exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+			m_pid = -1;
+		}
+	}
+	m_running = false;
+	if (m_onExit)
+		m_onExit();
+}
+
+#endif
+
+} // namespace blot
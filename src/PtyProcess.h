@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace blot {
+
+// Child process attached to a pseudo terminal (forkpty). A background thread
+// polls the master side, hands every chunk of output to the callback, and
+// flushes input queued by write(), so neither reading nor writing ever
+// blocks the caller. When the callback is slow the thread simply reads less
+// often and the kernel's pty buffer throttles the child. POSIX only; start()
+// fails elsewhere.
+class PtyProcess {
+  public:
+	using OutputCallback = std::function<void(const char *data, size_t size)>;
+
+	PtyProcess() = default;
+	~PtyProcess();
+
+	PtyProcess(const PtyProcess &) = delete;
+	PtyProcess &operator=(const PtyProcess &) = delete;
+
+	// Runs command through /bin/sh -c, or the user's $SHELL when empty.
+	// onOutput and onExit run on the reader thread.
+	bool start(const std::string &command, int cols, int rows,
+			   OutputCallback onOutput, std::function<void()> onExit = {});
+	// Hangs up the child and joins the reader thread
+	void stop();
+
+	bool isRunning() const { return m_running.load(); }
+	int getExitStatus() const { return m_exitStatus.load(); }
+	const std::string &getError() const { return m_error; }
+
+	// Any thread; queued and written by the reader thread
+	void write(const char *data, size_t size);
+	void write(const std::string &data) { write(data.data(), data.size()); }
+	void resize(int cols, int rows);
+
+  private:
+	void readerLoop();
+	void wake();
+
+	int m_master = -1;
+	int m_wakePipe[2] = {-1, -1};
+	int m_pid = -1;
+	std::thread m_reader;
+	std::atomic<bool> m_stop{false};
+	std::atomic<bool> m_running{false};
+	std::atomic<int> m_exitStatus{-1};
+	std::mutex m_inputMutex;
+	std::string m_input;
+	OutputCallback m_onOutput;
+	std::function<void()> m_onExit;
+	std::string m_error;
+};
+
+} // namespace blot
@@ -0,0 +1,897 @@
+#include "TerminalScreen.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace blot {
+
+static constexpr size_t kMaxOscLength = 4096;
+
+static uint32_t packColor(uint32_t r, uint32_t g, uint32_t b) {
+	// IM_COL32 layout, always opaque so it never equals kDefaultColor
+	return 0xFF000000u | (b << 16) | (g << 8) | r;
+}
+
+uint32_t TerminalScreen::paletteColor(int index) {
+	static const uint8_t base[16][3] = {
+		{0, 0, 0},		 {205, 49, 49},	  {13, 188, 121},  {229, 229, 16},
+		{36, 114, 200},	 {188, 63, 188},  {17, 168, 205},  {229, 229, 229},
+		{102, 102, 102}, {241, 76, 76},	  {35, 209, 139},  {245, 245, 67},
+		{59, 142, 234},	 {214, 112, 214}, {41, 184, 219},  {255, 255, 255},
+	};
+	index = std::clamp(index, 0, 255);
+	if (index < 16)
+		return packColor(base[index][0], base[index][1], base[index][2]);
+	if (index < 232) {
+		// 6x6x6 color cube
+		int i = index - 16;
+		auto level = [](int v) { return v == 0 ? 0u : uint32_t(55 + v * 40); };
+		return packColor(level(i / 36), level((i / 6) % 6), level(i % 6));
+	}
+	uint32_t gray = uint32_t(8 + (index - 232) * 10);
+	return packColor(gray, gray, gray);
+}
+
+// DEC special graphics for 0x60..0x7e (box drawing used by curses programs)
+static uint32_t lineDrawing(uint32_t c) {
+	static const uint16_t table[31] = {
+		0x25C6, 0x2592, 0x2409, 0x240C, 0x240D, 0x240A, 0x00B0, 0x00B1,
+		0x2424, 0x240B, 0x2518, 0x2510, 0x250C, 0x2514, 0x253C, 0x23BA,
+		0x23BB, 0x2500, 0x23BC, 0x23BD, 0x251C, 0x2524, 0x2534, 0x252C,
+		0x2502, 0x2264, 0x2265, 0x03C0, 0x2260, 0x00A3, 0x00B7,
+	};
+	return c >= 0x60 && c <= 0x7e ? table[c - 0x60] : c;
+}
+
+TerminalScreen::TerminalScreen(int cols, int rows, size_t scrollbackLines)
+	: m_cols(std::max(cols, 1)), m_rows(std::max(rows, 1)),
+	  m_scrollCapacity(std::max(scrollbackLines, size_t(1))) {
+	reset();
+}
+
+void TerminalScreen::reset() {
+	for (Buffer &buffer : m_buffers) {
+		buffer.cells.assign(size_t(m_cols) * m_rows, Cell());
+		buffer.rowMap.resize(m_rows);
+		for (int y = 0; y < m_rows; y++)
+			buffer.rowMap[y] = y;
+	}
+	m_active = 0;
+	m_dirty.assign(m_rows, 1);
+	resetTabs();
+	m_scrollCells.assign(m_scrollCapacity * m_cols, Cell());
+	m_scrollHead = 0;
+	m_scrollCount = 0;
+	m_cursor = Cursor();
+	m_savedCursor = Cursor();
+	m_wrapPending = false;
+	m_scrollTop = 0;
+	m_scrollBottom = m_rows - 1;
+	m_autoWrap = true;
+	m_insertMode = false;
+	m_cursorVisible = true;
+	m_applicationCursor = false;
+	m_bracketedPaste = false;
+	m_state = State::Ground;
+	m_utf8Remaining = 0;
+	m_title.clear();
+}
+
+void TerminalScreen::resetTabs() {
+	m_tabs.assign(m_cols, 0);
+	for (int x = 8; x < m_cols; x += 8)
+		m_tabs[x] = 1;
+}
+
+const TerminalScreen::Cell *TerminalScreen::row(int y) const {
+	const Buffer &buffer = m_buffers[m_active];
+	return buffer.cells.data() + size_t(buffer.rowMap[y]) * m_cols;
+}
+
+TerminalScreen::Cell *TerminalScreen::mutableRow(int y) {
+	Buffer &buffer = m_buffers[m_active];
+	return buffer.cells.data() + size_t(buffer.rowMap[y]) * m_cols;
+}
+
+const TerminalScreen::Cell *
+TerminalScreen::scrollbackRow(size_t index) const {
+	size_t slot = (m_scrollHead + m_scrollCapacity - m_scrollCount + index) %
+				  m_scrollCapacity;
+	return m_scrollCells.data() + slot * m_cols;
+}
+
+TerminalScreen::Cell TerminalScreen::blank() const {
+	// Erased cells take the current background (xterm's BCE)
+	Cell cell;
+	cell.bg = m_cursor.bg;
+	return cell;
+}
+
+void TerminalScreen::markDirty(int top, int bottom) {
+	std::fill(m_dirty.begin() + top, m_dirty.begin() + bottom + 1,
+			  uint8_t(1));
+}
+
+void TerminalScreen::resize(int cols, int rows) {
+	cols = std::max(cols, 1);
+	rows = std::max(rows, 1);
+	if (cols == m_cols && rows == m_rows)
+		return;
+
+	// Rows pushed off the top so the cursor stays on screen
+	const int shift = std::max(m_cursor.y - (rows - 1), 0);
+	if (m_active == 0) {
+		for (int y = 0; y < shift; y++)
+			pushScrollback(row(y));
+	}
+
+	const int copyCols = std::min(cols, m_cols);
+	// Scrollback rows are re-cut to the new width
+	std::vector<Cell> scrollCells(m_scrollCapacity * cols, Cell());
+	for (size_t i = 0; i < m_scrollCount; i++) {
+		const Cell *src = scrollbackRow(i);
+		std::copy(src, src + copyCols, scrollCells.begin() + i * cols);
+	}
+	m_scrollCells.swap(scrollCells);
+	m_scrollHead = m_scrollCount % m_scrollCapacity;
+
+	for (int b = 0; b < 2; b++) {
+		Buffer &buffer = m_buffers[b];
+		std::vector<Cell> cells(size_t(cols) * rows, Cell());
+		const int rowShift = b == m_active ? shift : 0;
+		for (int y = 0; y < rows && y + rowShift < m_rows; y++) {
+			const Cell *src =
+				buffer.cells.data() +
+				size_t(buffer.rowMap[y + rowShift]) * m_cols;
+			std::copy(src, src + copyCols, cells.begin() + size_t(y) * cols);
+		}
+		buffer.cells.swap(cells);
+		buffer.rowMap.resize(rows);
+		for (int y = 0; y < rows; y++)
+			buffer.rowMap[y] = y;
+	}
+
+	m_cols = cols;
+	m_rows = rows;
+	m_dirty.assign(m_rows, 1);
+	resetTabs();
+	m_cursor.y -= shift;
+	m_cursor.x = std::min(m_cursor.x, m_cols - 1);
+	m_savedCursor.x = std::min(m_savedCursor.x, m_cols - 1);
+	m_savedCursor.y = std::min(m_savedCursor.y, m_rows - 1);
+	m_wrapPending = false;
+	m_scrollTop = 0;
+	m_scrollBottom = m_rows - 1;
+}
+
+void TerminalScreen::pushScrollback(const Cell *cells) {
+	std::copy(cells, cells + m_cols,
+			  m_scrollCells.begin() + m_scrollHead * m_cols);
+	m_scrollHead = (m_scrollHead + 1) % m_scrollCapacity;
+	m_scrollCount = std::min(m_scrollCount + 1, m_scrollCapacity);
+	m_scrollPushed++;
+}
+
+void TerminalScreen::scrollUp(int top, int bottom, int count,
+							  bool toScrollback) {
+	count = std::min(count, bottom - top + 1);
+	if (count <= 0)
+		return;
+	// Only scrolls from the top of the primary screen feed the scrollback
+	if (toScrollback && top == 0 && m_active == 0) {
+		for (int y = 0; y < count; y++)
+			pushScrollback(row(y));
+	}
+	std::vector<int> &map = m_buffers[m_active].rowMap;
+	std::rotate(map.begin() + top, map.begin() + top + count,
+				map.begin() + bottom + 1);
+	for (int y = bottom - count + 1; y <= bottom; y++)
+		eraseCells(y, 0, m_cols);
+	markDirty(top, bottom);
+}
+
+void TerminalScreen::scrollDown(int top, int bottom, int count) {
+	count = std::min(count, bottom - top + 1);
+	if (count <= 0)
+		return;
+	std::vector<int> &map = m_buffers[m_active].rowMap;
+	std::rotate(map.begin() + top, map.begin() + bottom + 1 - count,
+				map.begin() + bottom + 1);
+	for (int y = top; y < top + count; y++)
+		eraseCells(y, 0, m_cols);
+	markDirty(top, bottom);
+}
+
+void TerminalScreen::eraseCells(int y, int from, int to) {
+	from = std::clamp(from, 0, m_cols);
+	to = std::clamp(to, from, m_cols);
+	Cell *cells = mutableRow(y);
+	std::fill(cells + from, cells + to, blank());
+	m_dirty[y] = 1;
+}
+
+void TerminalScreen::eraseDisplay(int mode) {
+	const int y = m_cursor.y;
+	switch (mode) {
+	case 0: // cursor to end
+		eraseCells(y, m_cursor.x, m_cols);
+		for (int i = y + 1; i < m_rows; i++)
+			eraseCells(i, 0, m_cols);
+		break;
+	case 1: // start to cursor
+		for (int i = 0; i < y; i++)
+			eraseCells(i, 0, m_cols);
+		eraseCells(y, 0, m_cursor.x + 1);
+		break;
+	case 2:
+		for (int i = 0; i < m_rows; i++)
+			eraseCells(i, 0, m_cols);
+		break;
+	case 3: // xterm: clear scrollback
+		m_scrollCount = 0;
+		m_scrollHead = 0;
+		break;
+	}
+}
+
+void TerminalScreen::lineFeed() {
+	if (m_cursor.y == m_scrollBottom) {
+		scrollUp(m_scrollTop, m_scrollBottom, 1, true);
+	} else if (m_cursor.y < m_rows - 1) {
+		m_cursor.y++;
+	}
+}
+
+void TerminalScreen::reverseIndex() {
+	if (m_cursor.y == m_scrollTop) {
+		scrollDown(m_scrollTop, m_scrollBottom, 1);
+	} else if (m_cursor.y > 0) {
+		m_cursor.y--;
+	}
+}
+
+void TerminalScreen::moveCursor(int x, int y) {
+	int top = 0;
+	int bottom = m_rows - 1;
+	if (m_cursor.originMode) {
+		top = m_scrollTop;
+		bottom = m_scrollBottom;
+		y += m_scrollTop;
+	}
+	m_cursor.x = std::clamp(x, 0, m_cols - 1);
+	m_cursor.y = std::clamp(y, top, bottom);
+	m_wrapPending = false;
+}
+
+void TerminalScreen::switchScreen(bool alternate) {
+	int target = alternate ? 1 : 0;
+	if (target == m_active)
+		return;
+	m_active = target;
+	if (alternate) {
+		for (int y = 0; y < m_rows; y++)
+			eraseCells(y, 0, m_cols);
+	}
+	markDirty(0, m_rows - 1);
+}
+
+void TerminalScreen::feed(const char *data, size_t size) {
+	auto bytes = reinterpret_cast<const unsigned char *>(data);
+	for (size_t i = 0; i < size; i++) {
+		// Fast path: printable ASCII in the ground state
+		if (m_state == State::Ground && m_utf8Remaining == 0 &&
+			bytes[i] >= 0x20 && bytes[i] < 0x7f) {
+			size_t end = i + 1;
+			while (end < size && bytes[end] >= 0x20 && bytes[end] < 0x7f)
+				end++;
+			printAscii(bytes + i, end - i);
+			i = end;
+			if (i == size)
+				break;
+		}
+		process(bytes[i]);
+	}
+}
+
+void TerminalScreen::process(unsigned char c) {
+	// Strings end at BEL or ST (ESC \); anything else after ESC ends the
+	// string and starts a new sequence
+	if (m_state == State::OscString || m_state == State::IgnoreString) {
+		if (m_stringEscape) {
+			m_stringEscape = false;
+			if (m_state == State::OscString)
+				oscDispatch();
+			m_state = State::Ground;
+			if (c == '\\')
+				return;
+			m_state = State::Escape;
+			m_private = m_intermediate = 0;
+			process(c);
+			return;
+		}
+		if (c == 0x1b) {
+			m_stringEscape = true;
+		} else if (c == 0x07) {
+			if (m_state == State::OscString)
+				oscDispatch();
+			m_state = State::Ground;
+		} else if (m_state == State::OscString && m_osc.size() < kMaxOscLength) {
+			m_osc.push_back(static_cast<char>(c));
+		}
+		return;
+	}
+
+	// Controls act in every other state
+	if (c == 0x1b) {
+		m_state = State::Escape;
+		m_private = m_intermediate = 0;
+		m_utf8Remaining = 0;
+		return;
+	}
+	if (c == 0x18 || c == 0x1a) { // CAN, SUB
+		m_state = State::Ground;
+		return;
+	}
+	if (c < 0x20) {
+		execute(c);
+		return;
+	}
+
+	switch (m_state) {
+	case State::Ground:
+		if (c < 0x80) {
+			m_utf8Remaining = 0;
+			if (c != 0x7f)
+				print(c);
+		} else if (c < 0xC0) {
+			if (m_utf8Remaining > 0) {
+				m_utf8Codepoint = (m_utf8Codepoint << 6) | (c & 0x3F);
+				if (--m_utf8Remaining == 0)
+					print(m_utf8Codepoint);
+			} else {
+				print(0xFFFD);
+			}
+		} else {
+			if (m_utf8Remaining > 0)
+				print(0xFFFD);
+			if (c < 0xE0) {
+				m_utf8Codepoint = c & 0x1F;
+				m_utf8Remaining = 1;
+			} else if (c < 0xF0) {
+				m_utf8Codepoint = c & 0x0F;
+				m_utf8Remaining = 2;
+			} else {
+				m_utf8Codepoint = c & 0x07;
+				m_utf8Remaining = 3;
+			}
+		}
+		break;
+	case State::Escape:
+		if (c == '[') {
+			m_state = State::CsiEntry;
+			m_paramCount = 0;
+			m_params[0] = 0;
+		} else if (c == ']') {
+			m_state = State::OscString;
+			m_osc.clear();
+		} else if (c == 'P' || c == 'X' || c == '^' || c == '_') {
+			m_state = State::IgnoreString;
+		} else if (c >= 0x20 && c <= 0x2f) {
+			m_intermediate = static_cast<char>(c);
+			m_state = State::EscapeIntermediate;
+		} else {
+			m_state = State::Ground;
+			escDispatch(c);
+		}
+		break;
+	case State::EscapeIntermediate:
+		if (c >= 0x20 && c <= 0x2f) {
+			m_intermediate = static_cast<char>(c);
+		} else {
+			m_state = State::Ground;
+			escDispatch(c);
+		}
+		break;
+	case State::CsiEntry:
+		if (c >= '<' && c <= '?') {
+			m_private = static_cast<char>(c);
+			m_state = State::CsiParam;
+			break;
+		}
+		[[fallthrough]];
+	case State::CsiParam:
+		if (c >= '0' && c <= '9') {
+			if (m_paramCount == 0)
+				m_paramCount = 1;
+			int &value = m_params[m_paramCount - 1];
+			value = std::min(value * 10 + (c - '0'), 65535);
+			m_state = State::CsiParam;
+		} else if (c == ';' || c == ':') {
+			if (m_paramCount == 0)
+				m_paramCount = 1;
+			if (m_paramCount < kMaxParams)
+				m_params[m_paramCount++] = 0;
+			m_state = State::CsiParam;
+		} else if (c >= 0x20 && c <= 0x2f) {
+			m_intermediate = static_cast<char>(c);
+			m_state = State::CsiIntermediate;
+		} else if (c >= 0x40 && c <= 0x7e) {
+			m_state = State::Ground;
+			csiDispatch(c);
+		} else {
+			m_state = State::CsiIgnore;
+		}
+		break;
+	case State::CsiIntermediate:
+		if (c >= 0x20 && c <= 0x2f) {
+			m_intermediate = static_cast<char>(c);
+		} else if (c >= 0x40 && c <= 0x7e) {
+			m_state = State::Ground;
+			csiDispatch(c);
+		} else {
+			m_state = State::CsiIgnore;
+		}
+		break;
+	case State::CsiIgnore:
+		if (c >= 0x40 && c <= 0x7e)
+			m_state = State::Ground;
+		break;
+	default:
+		break;
+	}
+}
+
+void TerminalScreen::execute(unsigned char c) {
+	switch (c) {
+	case '\b':
+		if (m_cursor.x > 0)
+			m_cursor.x--;
+		m_wrapPending = false;
+		break;
+	case '\t': {
+		int x = m_cursor.x + 1;
+		while (x < m_cols - 1 && !m_tabs[x])
+			x++;
+		m_cursor.x = std::min(x, m_cols - 1);
+		m_wrapPending = false;
+		break;
+	}
+	case '\n':
+	case '\v':
+	case '\f':
+		lineFeed();
+		m_wrapPending = false;
+		break;
+	case '\r':
+		m_cursor.x = 0;
+		m_wrapPending = false;
+		break;
+	case 0x0e: // SO/SI: G1 is not supported, stay on G0
+	case 0x0f:
+	default:
+		break;
+	}
+}
+
+void TerminalScreen::print(uint32_t codepoint) {
+	if (m_cursor.lineDrawing)
+		codepoint = lineDrawing(codepoint);
+	if (m_wrapPending) {
+		m_cursor.x = 0;
+		lineFeed();
+		m_wrapPending = false;
+	}
+	Cell *cells = mutableRow(m_cursor.y);
+	if (m_insertMode) {
+		std::copy_backward(cells + m_cursor.x, cells + m_cols - 1,
+						   cells + m_cols);
+	}
+	Cell &cell = cells[m_cursor.x];
+	cell.codepoint = codepoint;
+	cell.fg = m_cursor.fg;
+	cell.bg = m_cursor.bg;
+	cell.attrs = m_cursor.attrs;
+	m_dirty[m_cursor.y] = 1;
+	if (m_cursor.x == m_cols - 1) {
+		m_wrapPending = m_autoWrap;
+	} else {
+		m_cursor.x++;
+	}
+}
+
+void TerminalScreen::printAscii(const unsigned char *text, size_t count) {
+	while (count > 0) {
+		if (m_wrapPending || m_insertMode || m_cursor.lineDrawing) {
+			print(*text++);
+			count--;
+			continue;
+		}
+		// Fill up to the right margin in one go
+		Cell *cells = mutableRow(m_cursor.y) + m_cursor.x;
+		const int n = static_cast<int>(
+			std::min<size_t>(count, size_t(m_cols - m_cursor.x)));
+		for (int k = 0; k < n; k++) {
+			cells[k].codepoint = text[k];
+			cells[k].fg = m_cursor.fg;
+			cells[k].bg = m_cursor.bg;
+			cells[k].attrs = m_cursor.attrs;
+		}
+		m_dirty[m_cursor.y] = 1;
+		text += n;
+		count -= size_t(n);
+		if (m_cursor.x + n == m_cols) {
+			m_cursor.x = m_cols - 1;
+			m_wrapPending = m_autoWrap;
+		} else {
+			m_cursor.x += n;
+		}
+	}
+}
+
+int TerminalScreen::param(int index, int fallback) const {
+	return index < m_paramCount && m_params[index] > 0 ? m_params[index]
+													   : fallback;
+}
+
+void TerminalScreen::escDispatch(unsigned char final) {
+	if (m_intermediate == '(') {
+		// G0 designation: '0' is DEC line drawing, anything else plain
+		m_cursor.lineDrawing = final == '0';
+		return;
+	}
+	if (m_intermediate == '#') {
+		if (final == '8') { // DECALN: fill with 'E'
+			for (int y = 0; y < m_rows; y++) {
+				Cell *cells = mutableRow(y);
+				for (int x = 0; x < m_cols; x++)
+					cells[x] = Cell{'E'};
+			}
+			markDirty(0, m_rows - 1);
+		}
+		return;
+	}
+	if (m_intermediate)
+		return;
+	switch (final) {
+	case '7':
+		m_savedCursor = m_cursor;
+		break;
+	case '8':
+		m_cursor = m_savedCursor;
+		m_wrapPending = false;
+		break;
+	case 'D':
+		lineFeed();
+		break;
+	case 'E':
+		m_cursor.x = 0;
+		lineFeed();
+		break;
+	case 'H':
+		m_tabs[m_cursor.x] = 1;
+		break;
+	case 'M':
+		reverseIndex();
+		break;
+	case 'c': {
+		uint64_t pushed = m_scrollPushed;
+		reset();
+		m_scrollPushed = pushed;
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void TerminalScreen::csiDispatch(unsigned char final) {
+	if (m_private == '?' || (m_private == 0 && (final == 'h' || final == 'l'))) {
+		if (final == 'h' || final == 'l')
+			setMode(final == 'h');
+		return;
+	}
+	if (final == 'c') {
+		// Primary (and secondary, '>') device attributes
+		m_response += m_private == '>' ? "\x1b[>0;0;0c" : "\x1b[?1;2c";
+		return;
+	}
+	if (m_private || m_intermediate)
+		return;
+
+	const int n = param(0, 1);
+	Cursor &cur = m_cursor;
+	switch (final) {
+	case '@': { // ICH
+		Cell *cells = mutableRow(cur.y);
+		int count = std::min(n, m_cols - cur.x);
+		std::copy_backward(cells + cur.x, cells + m_cols - count,
+						   cells + m_cols);
+		std::fill(cells + cur.x, cells + cur.x + count, blank());
+		m_dirty[cur.y] = 1;
+		break;
+	}
+	case 'A':
+		cur.y = std::max(cur.y - n,
+						 cur.y >= m_scrollTop ? m_scrollTop : 0);
+		m_wrapPending = false;
+		break;
+	case 'B':
+	case 'e':
+		cur.y = std::min(cur.y + n,
+						 cur.y <= m_scrollBottom ? m_scrollBottom : m_rows - 1);
+		m_wrapPending = false;
+		break;
+	case 'C':
+	case 'a':
+		cur.x = std::min(cur.x + n, m_cols - 1);
+		m_wrapPending = false;
+		break;
+	case 'D':
+		cur.x = std::max(cur.x - n, 0);
+		m_wrapPending = false;
+		break;
+	case 'E':
+		cur.x = 0;
+		cur.y = std::min(cur.y + n, m_rows - 1);
+		m_wrapPending = false;
+		break;
+	case 'F':
+		cur.x = 0;
+		cur.y = std::max(cur.y - n, 0);
+		m_wrapPending = false;
+		break;
+	case 'G':
+	case '`':
+		cur.x = std::clamp(n - 1, 0, m_cols - 1);
+		m_wrapPending = false;
+		break;
+	case 'H':
+	case 'f':
+		moveCursor(param(1, 1) - 1, param(0, 1) - 1);
+		break;
+	case 'I':
+		for (int i = 0; i < n; i++)
+			execute('\t');
+		break;
+	case 'J':
+		eraseDisplay(param(0, 0));
+		break;
+	case 'K': {
+		int mode = param(0, 0);
+		if (mode == 0)
+			eraseCells(cur.y, cur.x, m_cols);
+		else if (mode == 1)
+			eraseCells(cur.y, 0, cur.x + 1);
+		else
+			eraseCells(cur.y, 0, m_cols);
+		break;
+	}
+	case 'L':
+		if (cur.y >= m_scrollTop && cur.y <= m_scrollBottom)
+			scrollDown(cur.y, m_scrollBottom, n);
+		break;
+	case 'M':
+		// Deleted lines never go to the scrollback
+		if (cur.y >= m_scrollTop && cur.y <= m_scrollBottom)
+			scrollUp(cur.y, m_scrollBottom, n, false);
+		break;
+	case 'P': { // DCH
+		Cell *cells = mutableRow(cur.y);
+		int count = std::min(n, m_cols - cur.x);
+		std::copy(cells + cur.x + count, cells + m_cols, cells + cur.x);
+		std::fill(cells + m_cols - count, cells + m_cols, blank());
+		m_dirty[cur.y] = 1;
+		break;
+	}
+	case 'S':
+		scrollUp(m_scrollTop, m_scrollBottom, n, true);
+		break;
+	case 'T':
+		scrollDown(m_scrollTop, m_scrollBottom, n);
+		break;
+	case 'X':
+		eraseCells(cur.y, cur.x, cur.x + n);
+		break;
+	case 'Z':
+		for (int i = 0; i < n && cur.x > 0; i++) {
+			do {
+				cur.x--;
+			} while (cur.x > 0 && !m_tabs[cur.x]);
+		}
+		break;
+	case 'd':
+		moveCursor(cur.x, n - 1);
+		break;
+	case 'g':
+		if (param(0, 0) == 3)
+			std::fill(m_tabs.begin(), m_tabs.end(), uint8_t(0));
+		else
+			m_tabs[cur.x] = 0;
+		break;
+	case 'm':
+		selectGraphicRendition();
+		break;
+	case 'n':
+		if (param(0, 0) == 5) {
+			m_response += "\x1b[0n";
+		} else if (param(0, 0) == 6) {
+			char reply[32];
+			int y = cur.originMode ? cur.y - m_scrollTop : cur.y;
+			snprintf(reply, sizeof(reply), "\x1b[%d;%dR", y + 1, cur.x + 1);
+			m_response += reply;
+		}
+		break;
+	case 'r': {
+		int top = param(0, 1) - 1;
+		int bottom = param(1, m_rows) - 1;
+		if (top < bottom && bottom < m_rows) {
+			m_scrollTop = top;
+			m_scrollBottom = bottom;
+			moveCursor(0, 0);
+		}
+		break;
+	}
+	case 's':
+		m_savedCursor = m_cursor;
+		break;
+	case 'u':
+		m_cursor = m_savedCursor;
+		m_wrapPending = false;
+		break;
+	default:
+		break;
+	}
+}
+
+void TerminalScreen::setMode(bool enable) {
+	for (int i = 0; i < std::max(m_paramCount, 1); i++) {
+		int mode = m_params[i];
+		if (m_private != '?') {
+			if (mode == 4)
+				m_insertMode = enable;
+			continue;
+		}
+		switch (mode) {
+		case 1:
+			m_applicationCursor = enable;
+			break;
+		case 6:
+			m_cursor.originMode = enable;
+			moveCursor(0, 0);
+			break;
+		case 7:
+			m_autoWrap = enable;
+			break;
+		case 25:
+			m_cursorVisible = enable;
+			break;
+		case 47:
+		case 1047:
+			switchScreen(enable);
+			break;
+		case 1048:
+			if (enable)
+				m_savedCursor = m_cursor;
+			else
+				m_cursor = m_savedCursor;
+			break;
+		case 1049:
+			if (enable) {
+				m_savedCursor = m_cursor;
+				switchScreen(true);
+			} else {
+				switchScreen(false);
+				m_cursor = m_savedCursor;
+			}
+			m_wrapPending = false;
+			break;
+		case 2004:
+			m_bracketedPaste = enable;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void TerminalScreen::selectGraphicRendition() {
+	Cursor &cur = m_cursor;
+	if (m_paramCount == 0) {
+		cur.fg = cur.bg = kDefaultColor;
+		cur.attrs = 0;
+		return;
+	}
+	for (int i = 0; i < m_paramCount; i++) {
+		int p = m_params[i];
+		if (p == 38 || p == 48) {
+			// 38;5;n or 38;2;r;g;b
+			uint32_t color = kDefaultColor;
+			if (i + 2 < m_paramCount && m_params[i + 1] == 5) {
+				color = paletteColor(m_params[i + 2]);
+				i += 2;
+			} else if (i + 4 < m_paramCount && m_params[i + 1] == 2) {
+				color = packColor(std::min(m_params[i + 2], 255),
+								  std::min(m_params[i + 3], 255),
+								  std::min(m_params[i + 4], 255));
+				i += 4;
+			} else {
+				break;
+			}
+			(p == 38 ? cur.fg : cur.bg) = color;
+			continue;
+		}
+		switch (p) {
+		case 0:
+			cur.fg = cur.bg = kDefaultColor;
+			cur.attrs = 0;
+			break;
+		case 1:
+			cur.attrs |= Bold;
+			break;
+		case 2:
+			cur.attrs |= Dim;
+			break;
+		case 3:
+			cur.attrs |= Italic;
+			break;
+		case 4:
+			cur.attrs |= Underline;
+			break;
+		case 7:
+			cur.attrs |= Inverse;
+			break;
+		case 8:
+			cur.attrs |= Hidden;
+			break;
+		case 9:
+			cur.attrs |= Strike;
+			break;
+		case 21:
+		case 22:
+			cur.attrs &= ~(Bold | Dim);
+			break;
+		case 23:
+			cur.attrs &= ~Italic;
+			break;
+		case 24:
+			cur.attrs &= ~Underline;
+			break;
+		case 27:
+			cur.attrs &= ~Inverse;
+			break;
+		case 28:
+			cur.attrs &= ~Hidden;
+			break;
+		case 29:
+			cur.attrs &= ~Strike;
+			break;
+		case 39:
+			cur.fg = kDefaultColor;
+			break;
+		case 49:
+			cur.bg = kDefaultColor;
+			break;
+		default:
+			if (p >= 30 && p <= 37)
+				cur.fg = paletteColor(p - 30);
+			else if (p >= 40 && p <= 47)
+				cur.bg = paletteColor(p - 40);
+			else if (p >= 90 && p <= 97)
+				cur.fg = paletteColor(p - 90 + 8);
+			else if (p >= 100 && p <= 107)
+				cur.bg = paletteColor(p - 100 + 8);
+			break;
+		}
+	}
+}
+
+void TerminalScreen::oscDispatch() {
+	// OSC 0 / 2: window title
+	size_t separator = m_osc.find(';');
+	if (separator == std::string::npos)
+		return;
+	if (m_osc.compare(0, separator, "0") == 0 ||
+		m_osc.compare(0, separator, "2") == 0)
+		m_title = m_osc.substr(separator + 1);
+}
+
+} // namespace blot
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace blot {
+
+// Cell grid of a VT100/xterm terminal plus a circular scrollback buffer.
+// feed() runs the escape-sequence state machine (after Paul Williams' DEC
+// parser) straight over the output bytes, with a fast path for runs of
+// printable ASCII. Screen rows are reached through a row map, so scrolling
+// rotates indices instead of moving cells. Not synchronized; the owner
+// guards it.
+class TerminalScreen {
+  public:
+	// Packed IM_COL32 values; kDefaultColor means "the theme's color"
+	static constexpr uint32_t kDefaultColor = 0;
+
+	enum Attr : uint16_t {
+		Bold = 1 << 0,
+		Dim = 1 << 1,
+		Italic = 1 << 2,
+		Underline = 1 << 3,
+		Inverse = 1 << 4,
+		Hidden = 1 << 5,
+		Strike = 1 << 6,
+	};
+
+	struct Cell {
+		uint32_t codepoint = ' ';
+		uint32_t fg = kDefaultColor;
+		uint32_t bg = kDefaultColor;
+		uint16_t attrs = 0;
+	};
+
+	TerminalScreen(int cols = 80, int rows = 24,
+				   size_t scrollbackLines = 5000);
+
+	void feed(const char *data, size_t size);
+	void resize(int cols, int rows);
+	void reset();
+
+	int cols() const { return m_cols; }
+	int rows() const { return m_rows; }
+	const Cell *row(int y) const;
+
+	// Dirty flags per screen row, set by any change to the row
+	bool isRowDirty(int y) const { return m_dirty[y] != 0; }
+	void clearDirty(int y) { m_dirty[y] = 0; }
+
+	// Lines that scrolled off the top of the primary screen; 0 is the oldest
+	size_t scrollbackSize() const { return m_scrollCount; }
+	size_t scrollbackCapacity() const { return m_scrollCapacity; }
+	const Cell *scrollbackRow(size_t index) const;
+	// Lines ever pushed to the scrollback (keeps counting once it is full)
+	uint64_t scrollbackPushed() const { return m_scrollPushed; }
+
+	int cursorX() const { return m_cursor.x; }
+	int cursorY() const { return m_cursor.y; }
+	bool isCursorVisible() const { return m_cursorVisible; }
+	bool isAltScreen() const { return m_active == 1; }
+	bool isApplicationCursorKeys() const { return m_applicationCursor; }
+	bool isBracketedPaste() const { return m_bracketedPaste; }
+	const std::string &title() const { return m_title; }
+
+	// Replies the terminal owes the program (DSR, DA); write them back to it
+	void takeResponse(std::string &out) {
+		out.swap(m_response);
+		m_response.clear();
+	}
+
+	static uint32_t paletteColor(int index);
+
+  private:
+	enum class State {
+		Ground,
+		Escape,
+		EscapeIntermediate,
+		CsiEntry,
+		CsiParam,
+		CsiIntermediate,
+		CsiIgnore,
+		OscString,
+		IgnoreString, // DCS, SOS, PM, APC: dropped up to ST
+	};
+
+	struct Cursor {
+		int x = 0;
+		int y = 0;
+		uint32_t fg = kDefaultColor;
+		uint32_t bg = kDefaultColor;
+		uint16_t attrs = 0;
+		bool originMode = false;
+		bool lineDrawing = false;
+	};
+
+	// Primary and alternate screens
+	struct Buffer {
+		std::vector<Cell> cells;
+		std::vector<int> rowMap; // screen row -> row in cells
+	};
+
+	void process(unsigned char c);
+	void execute(unsigned char c);
+	void print(uint32_t codepoint);
+	void printAscii(const unsigned char *text, size_t count);
+	void escDispatch(unsigned char final);
+	void csiDispatch(unsigned char final);
+	void oscDispatch();
+	void setMode(bool enable);
+	void selectGraphicRendition();
+	int param(int index, int fallback) const;
+
+	Cell *mutableRow(int y);
+	Cell blank() const;
+	void markDirty(int top, int bottom);
+	void lineFeed();
+	void reverseIndex();
+	void scrollUp(int top, int bottom, int count, bool toScrollback);
+	void scrollDown(int top, int bottom, int count);
+	void eraseCells(int y, int from, int to);
+	void eraseDisplay(int mode);
+	void pushScrollback(const Cell *cells);
+	void moveCursor(int x, int y);
+	void switchScreen(bool alternate);
+	void resetTabs();
+
+	int m_cols;
+	int m_rows;
+	Buffer m_buffers[2];
+	int m_active = 0;
+	std::vector<uint8_t> m_dirty;
+	std::vector<uint8_t> m_tabs;
+
+	std::vector<Cell> m_scrollCells; // m_scrollCapacity rows of m_cols
+	size_t m_scrollCapacity;
+	size_t m_scrollHead = 0; // slot of the next pushed row
+	size_t m_scrollCount = 0;
+	uint64_t m_scrollPushed = 0;
+
+	Cursor m_cursor;
+	Cursor m_savedCursor;
+	bool m_wrapPending = false;
+	int m_scrollTop = 0;
+	int m_scrollBottom = 0;
+	bool m_autoWrap = true;
+	bool m_insertMode = false;
+	bool m_cursorVisible = true;
+	bool m_applicationCursor = false;
+	bool m_bracketedPaste = false;
+
+	State m_state = State::Ground;
+	static constexpr int kMaxParams = 16;
+	int m_params[kMaxParams] = {};
+	int m_paramCount = 0;
+	char m_private = 0;
+	char m_intermediate = 0;
+	bool m_stringEscape = false;
+	std::string m_osc;
+	uint32_t m_utf8Codepoint = 0;
+	int m_utf8Remaining = 0;
+
+	std::string m_title;
+	std::string m_response;
+};
+
+} // namespace blot
@@ -1,21 +1,454 @@
 #include "TerminalWindow.h"
 #include <algorithm>
+#include <cctype>
 #include <imgui.h>
 #include <iostream>
+#include "GlyphLoader.h"
 
 namespace blot {
 
+static constexpr size_t kMaxCommandHistory = 500;
+
 TerminalWindow::TerminalWindow(const std::string &title, Flags flags)
-	: Window(title, flags) {
+	: Window(title, flags), m_runner([this]() { requestRedraw(); }) {
+	registerBuiltinCommands();
 	// Add welcome message
 	addLog("Terminal initialized. Type 'help' for available commands.");
 }
 
+TerminalWindow::~TerminalWindow() {
+	m_runner.cancel();
+	// The reader thread feeds m_screen; stop it before members go away
+	m_pty.stop();
+}
+
+void TerminalWindow::update() {
+	// Output of running commands, streamed in as it arrives
+	m_outputScratch.clear();
+	if (m_runner.takeOutput(m_outputScratch) == 0)
+		return;
+	for (CommandRunner::Output &output : m_outputScratch)
+		addLog(output.text);
+	m_scrollToBottom = true;
+}
+
+void TerminalWindow::cancelCommand() {
+	if (!m_runner.isBusy())
+		return;
+	m_runner.cancel();
+	addLog("^C");
+	m_scrollToBottom = true;
+}
+
+void TerminalWindow::registerBuiltinCommands() {
+	using Type = CommandArg::Type;
+	// The built-ins touch the console itself, so they run on the UI thread
+	auto add = [this](std::string name, std::vector<std::string> aliases,
+					  std::string description, std::vector<CommandArg> args,
+					  std::function<void(CommandContext &)> handler) {
+		Command command;
+		command.name = std::move(name);
+		command.aliases = std::move(aliases);
+		command.description = std::move(description);
+		command.args = std::move(args);
+		command.execution = Command::Execution::UiThread;
+		command.handler = std::move(handler);
+		m_commands.add(std::move(command));
+	};
+
+	add("help", {"h"}, "Show commands, or the usage of one",
+		{{"command", Type::String, true}}, [this](CommandContext &ctx) {
+			if (!ctx.has(0)) {
+				ctx.print("Available commands:");
+				for (const Command *command : m_commands.list()) {
+					std::string line = "  " + command->usage();
+					line.resize((std::max)(line.size(), size_t(20)), ' ');
+					ctx.print(line + " - " + command->description);
+				}
+				return;
+			}
+			const Command *command = m_commands.find(ctx.arg(0));
+			if (!command) {
+				ctx.error("No command '" + ctx.arg(0) + "'");
+				return;
+			}
+			ctx.print("Usage: " + command->usage());
+			ctx.print("  " + command->description);
+			for (const CommandArg &arg : command->args) {
+				if (!arg.description.empty())
+					ctx.print("  " + arg.name + ": " + arg.description);
+			}
+		});
+	add("clear", {"cls"}, "Clear terminal", {},
+		[this](CommandContext &) { clearLog(); });
+	add("version", {}, "Show version info", {},
+		[](CommandContext &ctx) { ctx.print("Blot Terminal v1.0.0"); });
+	add("echo", {}, "Echo text", {{"text", Type::Rest, true}},
+		[](CommandContext &ctx) { ctx.print(ctx.arg(0)); });
+	add("history", {}, "Show entered commands",
+		{{"prefix", Type::Rest, true, "Only commands starting with this"}},
+		[this](CommandContext &ctx) {
+			const std::string &prefix = ctx.arg(0);
+			for (const auto &entry : m_commandHistory) {
+				if (entry.second.compare(0, prefix.size(), prefix) == 0)
+					ctx.print("  " + entry.second);
+			}
+		});
+	add("shell", {}, "Run a shell (or cmd) in this terminal",
+		{{"cmd", Type::Rest, true}},
+		[this](CommandContext &ctx) { startShell(ctx.arg(0)); });
+}
+
 void TerminalWindow::renderContents() {
+	if (m_shellMode && !m_pty.isRunning()) {
+		m_pty.stop();
+		m_shellMode = false;
+		addLog("Shell exited with status " +
+			   std::to_string(m_pty.getExitStatus()) + ".");
+		m_scrollToBottom = true;
+	}
+	if (m_shellMode) {
+		renderShell();
+		return;
+	}
 	renderLogHistory();
 	renderInput();
 }
 
+bool TerminalWindow::startShell(const std::string &command) {
+	stopShell();
+	{
+		std::lock_guard<std::mutex> lock(m_screenMutex);
+		m_screen.reset();
+	}
+	m_followOutput = true;
+	bool started = m_pty.start(
+		command, m_screen.cols(), m_screen.rows(),
+		[this](const char *data, size_t size) {
+			std::string response;
+			{
+				std::lock_guard<std::mutex> lock(m_screenMutex);
+				m_screen.feed(data, size);
+				m_screen.takeResponse(response);
+			}
+			if (!response.empty())
+				m_pty.write(response);
+			requestRedraw();
+		},
+		[this]() { requestRedraw(); });
+	if (!started) {
+		addLog("Cannot start shell: " + m_pty.getError());
+		return false;
+	}
+	m_shellMode = true;
+	return true;
+}
+
+void TerminalWindow::stopShell() {
+	m_pty.stop();
+	m_shellMode = false;
+}
+
+void TerminalWindow::syncScreen() {
+	// m_screenMutex held: copy only the rows that changed
+	const int cols = m_screen.cols();
+	const int rows = m_screen.rows();
+	if (cols != m_cacheCols || rows != m_cacheRows) {
+		m_rowCache.assign(size_t(cols) * rows, TerminalScreen::Cell());
+		m_cacheCols = cols;
+		m_cacheRows = rows;
+	}
+	for (int y = 0; y < rows; y++) {
+		if (!m_screen.isRowDirty(y))
+			continue;
+		const TerminalScreen::Cell *row = m_screen.row(y);
+		std::copy(row, row + cols, m_rowCache.begin() + size_t(y) * cols);
+		m_screen.clearDirty(y);
+	}
+	m_scrollbackSize = m_screen.scrollbackSize();
+	m_cursorX = m_screen.cursorX();
+	m_cursorY = m_screen.cursorY();
+	m_cursorVisible = m_screen.isCursorVisible();
+	m_applicationCursor = m_screen.isApplicationCursorKeys();
+	m_bracketedPaste = m_screen.isBracketedPaste();
+}
+
+void TerminalWindow::renderShell() {
+	const float lineHeight = ImGui::GetTextLineHeight();
+	const float cellWidth = ImGui::CalcTextSize("M").x;
+	ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0, 0, 0, 1));
+	ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
+	ImGui::BeginChild("Screen", ImVec2(0, 0), true,
+					  ImGuiWindowFlags_NoNavInputs |
+						  ImGuiWindowFlags_AlwaysVerticalScrollbar);
+
+	// The pty follows the size of the view
+	const ImVec2 avail = ImGui::GetContentRegionAvail();
+	const int cols = (std::max)(static_cast<int>(avail.x / cellWidth), 2);
+	const int rows = (std::max)(static_cast<int>(avail.y / lineHeight), 1);
+	bool resized = false;
+	uint64_t pushed = 0;
+	size_t capacity = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_screenMutex);
+		if (cols != m_screen.cols() || rows != m_screen.rows()) {
+			m_screen.resize(cols, rows);
+			resized = true;
+		}
+		syncScreen();
+		pushed = m_screen.scrollbackPushed();
+		capacity = m_screen.scrollbackCapacity();
+	}
+	if (resized)
+		m_pty.resize(cols, rows);
+	const bool sentInput = ImGui::IsWindowFocused() && sendShellInput();
+
+	// Scrolled back while the scrollback ring is full: every line dropped
+	// from the front moves the content up, so move the view with it
+	if (!m_followOutput) {
+		auto dropped = [capacity](uint64_t count) {
+			return count > capacity ? count - capacity : 0;
+		};
+		uint64_t lines = dropped(pushed) - dropped(m_scrollbackPushed);
+		if (lines > 0) {
+			ImGui::SetScrollY((std::max)(
+				ImGui::GetScrollY() - static_cast<float>(lines) * lineHeight,
+				0.0f));
+		}
+	}
+	m_scrollbackPushed = pushed;
+
+	ImDrawList *drawList = ImGui::GetWindowDrawList();
+	const float x0 = ImGui::GetCursorScreenPos().x;
+	const int totalLines = static_cast<int>(m_scrollbackSize) + m_cacheRows;
+	ImGuiListClipper clipper;
+	clipper.Begin(totalLines, lineHeight);
+	while (clipper.Step()) {
+		const int begin = clipper.DisplayStart;
+		const int end = clipper.DisplayEnd;
+		// Scrollback rows are copied out under the lock; the ring may have
+		// moved since syncScreen(), which at worst shifts them for a frame
+		const int scrollEnd =
+			(std::min)(end, static_cast<int>(m_scrollbackSize));
+		if (begin < scrollEnd) {
+			std::lock_guard<std::mutex> lock(m_screenMutex);
+			const int available =
+				(std::min)(scrollEnd,
+						   static_cast<int>(m_screen.scrollbackSize()));
+			m_lineScratch.resize(size_t(scrollEnd - begin) * m_cacheCols);
+			for (int line = begin; line < available; line++) {
+				const TerminalScreen::Cell *row =
+					m_screen.scrollbackRow(static_cast<size_t>(line));
+				std::copy(row, row + m_cacheCols,
+						  m_lineScratch.begin() +
+							  size_t(line - begin) * m_cacheCols);
+			}
+		}
+		for (int line = begin; line < end; line++) {
+			const ImVec2 pos(x0, clipper.StartPosY +
+									 static_cast<float>(line - begin) *
+										 lineHeight);
+			const TerminalScreen::Cell *cells =
+				line < scrollEnd
+					? m_lineScratch.data() + size_t(line - begin) * m_cacheCols
+					: m_rowCache.data() +
+						  size_t(line - m_scrollbackSize) * m_cacheCols;
+			drawShellRow(drawList, cells, m_cacheCols, pos, cellWidth,
+						 lineHeight);
+		}
+		const int cursorLine = static_cast<int>(m_scrollbackSize) + m_cursorY;
+		if (m_cursorVisible && cursorLine >= begin && cursorLine < end) {
+			ImVec2 min(x0 + static_cast<float>(m_cursorX) * cellWidth,
+					   clipper.StartPosY +
+						   static_cast<float>(cursorLine - begin) * lineHeight);
+			ImVec2 max(min.x + cellWidth, min.y + lineHeight);
+			ImU32 color = ImGui::GetColorU32(ImGuiCol_Text, 0.6f);
+			if (ImGui::IsWindowFocused())
+				drawList->AddRectFilled(min, max, color);
+			else
+				drawList->AddRect(min, max, color);
+		}
+		// Rows are drawn directly; reserve their space for the clipper
+		ImGui::SetCursorScreenPos(ImVec2(x0, clipper.StartPosY));
+		ImGui::Dummy(ImVec2(static_cast<float>(m_cacheCols) * cellWidth,
+							static_cast<float>(end - begin) * lineHeight));
+	}
+
+	// Follow the output while the view is at the bottom, or after typing
+	m_followOutput = sentInput ||
+					 ImGui::GetScrollY() >= ImGui::GetScrollMaxY() - 1.0f;
+	if (m_followOutput)
+		ImGui::SetScrollHereY(1.0f);
+
+	ImGui::EndChild();
+	ImGui::PopStyleVar();
+	ImGui::PopStyleColor();
+}
+
+void TerminalWindow::drawShellRow(ImDrawList *drawList,
+								  const TerminalScreen::Cell *cells, int cols,
+								  ImVec2 pos, float cellWidth,
+								  float lineHeight) {
+	const ImU32 defaultFg = ImGui::GetColorU32(ImGuiCol_Text);
+	const ImU32 defaultBg = IM_COL32(0, 0, 0, 255);
+	ImFont *font = ImGui::GetFont();
+	const float fontSize = ImGui::GetFontSize();
+
+	auto colors = [&](const TerminalScreen::Cell &cell, ImU32 &fg,
+					  ImU32 &bg) {
+		fg = cell.fg != TerminalScreen::kDefaultColor ? cell.fg : defaultFg;
+		bg = cell.bg;
+		if (cell.attrs & TerminalScreen::Inverse) {
+			ImU32 swapped = bg != TerminalScreen::kDefaultColor ? bg
+																: defaultBg;
+			bg = fg;
+			fg = swapped;
+		}
+		if (cell.attrs & TerminalScreen::Dim)
+			fg = (fg & 0x00FFFFFFu) | 0x80000000u;
+	};
+
+	// Backgrounds as runs of equal color, then glyphs cell by cell so the
+	// grid holds with proportional fonts too
+	int runStart = 0;
+	ImU32 runColor = TerminalScreen::kDefaultColor;
+	for (int x = 0; x <= cols; x++) {
+		ImU32 fg = 0;
+		ImU32 bg = TerminalScreen::kDefaultColor;
+		if (x < cols)
+			colors(cells[x], fg, bg);
+		if (x == cols || bg != runColor) {
+			if (runColor != TerminalScreen::kDefaultColor && x > runStart) {
+				drawList->AddRectFilled(
+					ImVec2(pos.x + static_cast<float>(runStart) * cellWidth,
+						   pos.y),
+					ImVec2(pos.x + static_cast<float>(x) * cellWidth,
+						   pos.y + lineHeight),
+					runColor);
+			}
+			runStart = x;
+			runColor = bg;
+		}
+	}
+	for (int x = 0; x < cols; x++) {
+		const TerminalScreen::Cell &cell = cells[x];
+		if (cell.attrs & TerminalScreen::Hidden)
+			continue;
+		ImU32 fg = 0;
+		ImU32 bg = 0;
+		colors(cell, fg, bg);
+		const ImVec2 cellPos(pos.x + static_cast<float>(x) * cellWidth,
+							 pos.y);
+		if (cell.codepoint > ' ') {
+			ImWchar c = cell.codepoint <= IM_UNICODE_CODEPOINT_MAX
+							? static_cast<ImWchar>(cell.codepoint)
+							: static_cast<ImWchar>('?');
+			font->RenderChar(drawList, fontSize, cellPos, fg, c);
+		}
+		if (cell.attrs & TerminalScreen::Underline) {
+			drawList->AddLine(
+				ImVec2(cellPos.x, cellPos.y + lineHeight - 1.0f),
+				ImVec2(cellPos.x + cellWidth, cellPos.y + lineHeight - 1.0f),
+				fg);
+		}
+		if (cell.attrs & TerminalScreen::Strike) {
+			drawList->AddLine(
+				ImVec2(cellPos.x, cellPos.y + lineHeight * 0.5f),
+				ImVec2(cellPos.x + cellWidth, cellPos.y + lineHeight * 0.5f),
+				fg);
+		}
+	}
+}
+
+static void appendUtf8(std::string &out, unsigned int c) {
+	if (c < 0x80) {
+		out += static_cast<char>(c);
+	} else if (c < 0x800) {
+		out += static_cast<char>(0xC0 | (c >> 6));
+		out += static_cast<char>(0x80 | (c & 0x3F));
+	} else if (c < 0x10000) {
+		out += static_cast<char>(0xE0 | (c >> 12));
+		out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (c & 0x3F));
+	} else {
+		out += static_cast<char>(0xF0 | (c >> 18));
+		out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (c & 0x3F));
+	}
+}
+
+bool TerminalWindow::sendShellInput() {
+	struct KeySequence {
+		ImGuiKey key;
+		const char *normal;
+		const char *application; // DECCKM cursor keys
+	};
+	static const KeySequence kKeys[] = {
+		{ImGuiKey_Enter, "\r", nullptr},
+		{ImGuiKey_KeypadEnter, "\r", nullptr},
+		{ImGuiKey_Backspace, "\x7f", nullptr},
+		{ImGuiKey_Tab, "\t", nullptr},
+		{ImGuiKey_Escape, "\x1b", nullptr},
+		{ImGuiKey_UpArrow, "\x1b[A", "\x1bOA"},
+		{ImGuiKey_DownArrow, "\x1b[B", "\x1bOB"},
+		{ImGuiKey_RightArrow, "\x1b[C", "\x1bOC"},
+		{ImGuiKey_LeftArrow, "\x1b[D", "\x1bOD"},
+		{ImGuiKey_Home, "\x1b[H", "\x1bOH"},
+		{ImGuiKey_End, "\x1b[F", "\x1bOF"},
+		{ImGuiKey_Insert, "\x1b[2~", nullptr},
+		{ImGuiKey_Delete, "\x1b[3~", nullptr},
+		{ImGuiKey_PageUp, "\x1b[5~", nullptr},
+		{ImGuiKey_PageDown, "\x1b[6~", nullptr},
+		{ImGuiKey_F1, "\x1bOP", nullptr},
+		{ImGuiKey_F2, "\x1bOQ", nullptr},
+		{ImGuiKey_F3, "\x1bOR", nullptr},
+		{ImGuiKey_F4, "\x1bOS", nullptr},
+		{ImGuiKey_F5, "\x1b[15~", nullptr},
+		{ImGuiKey_F6, "\x1b[17~", nullptr},
+		{ImGuiKey_F7, "\x1b[18~", nullptr},
+		{ImGuiKey_F8, "\x1b[19~", nullptr},
+		{ImGuiKey_F9, "\x1b[20~", nullptr},
+		{ImGuiKey_F10, "\x1b[21~", nullptr},
+		{ImGuiKey_F11, "\x1b[23~", nullptr},
+		{ImGuiKey_F12, "\x1b[24~", nullptr},
+	};
+
+	ImGuiIO &io = ImGui::GetIO();
+	std::string &out = m_keyInput;
+	out.clear();
+	if (io.KeyCtrl && io.KeyShift && ImGui::IsKeyPressed(ImGuiKey_V)) {
+		const char *clipboard = ImGui::GetClipboardText();
+		if (clipboard) {
+			if (m_bracketedPaste)
+				out += "\x1b[200~";
+			out += clipboard;
+			if (m_bracketedPaste)
+				out += "\x1b[201~";
+		}
+	} else if (io.KeyCtrl) {
+		// Ctrl+A..Z -> 0x01..0x1a
+		for (int key = ImGuiKey_A; key <= ImGuiKey_Z; key++) {
+			if (ImGui::IsKeyPressed(static_cast<ImGuiKey>(key)))
+				out += static_cast<char>(key - ImGuiKey_A + 1);
+		}
+	}
+	for (const KeySequence &entry : kKeys) {
+		if (ImGui::IsKeyPressed(entry.key)) {
+			out += m_applicationCursor && entry.application
+					   ? entry.application
+					   : entry.normal;
+		}
+	}
+	for (ImWchar c : io.InputQueueCharacters)
+		appendUtf8(out, c);
+	io.InputQueueCharacters.resize(0);
+	if (out.empty())
+		return false;
+	m_pty.write(out);
+	return true;
+}
+
 void TerminalWindow::renderLogHistory() {
 	// Create a child window for the log history
 	ImGui::BeginChild("LogHistory",
@@ -34,17 +467,31 @@ void TerminalWindow::renderLogHistory() {
 }
 
 void TerminalWindow::renderInput() {
+	const std::string running = m_runner.getCurrentCommand();
+	const std::string hint =
+		running.empty() ? std::string()
+						: "Running '" + running + "'... Ctrl+C to cancel";
 	ImGui::PushItemWidth(-1);
-	if (ImGui::InputText("##Command", m_inputBuffer, sizeof(m_inputBuffer),
-						 ImGuiInputTextFlags_EnterReturnsTrue)) {
+	if (ImGui::InputTextWithHint("##Command", hint.c_str(), m_inputBuffer,
+								 sizeof(m_inputBuffer),
+								 ImGuiInputTextFlags_EnterReturnsTrue |
+									 ImGuiInputTextFlags_CallbackCompletion |
+									 ImGuiInputTextFlags_CallbackHistory,
+								 &TerminalWindow::inputCallback, this)) {
 		std::string command = m_inputBuffer;
 		if (!command.empty()) {
 			addLog("> " + command);
+			addHistory(command);
 			processCommand(command);
 			m_inputBuffer[0] = '\0'; // Clear input
 			m_scrollToBottom = true;
 		}
 	}
+	// Ctrl+C copies a selection; on an empty line it cancels
+	if (ImGui::IsItemActive() && m_inputBuffer[0] == '\0' &&
+		ImGui::GetIO().KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_C)) {
+		cancelCommand();
+	}
 	ImGui::PopItemWidth();
 
 	// Auto-focus on input
@@ -53,38 +500,124 @@ void TerminalWindow::renderInput() {
 	}
 }
 
+int TerminalWindow::inputCallback(ImGuiInputTextCallbackData *data) {
+	auto *self = static_cast<TerminalWindow *>(data->UserData);
+	if (data->EventFlag == ImGuiInputTextFlags_CallbackCompletion)
+		self->completeInput(data);
+	else if (data->EventFlag == ImGuiInputTextFlags_CallbackHistory)
+		self->browseHistory(data);
+	return 0;
+}
+
+void TerminalWindow::completeInput(ImGuiInputTextCallbackData *data) {
+	const std::string line(data->Buf, static_cast<size_t>(data->CursorPos));
+	const size_t nameEnd = line.find_first_of(" \t");
+	if (nameEnd != std::string::npos) {
+		// Past the command name: show what it expects
+		const Command *command = m_commands.find(line.substr(0, nameEnd));
+		if (command) {
+			addLog("Usage: " + command->usage());
+			m_scrollToBottom = true;
+		}
+		return;
+	}
+	std::string prefix = line;
+	std::transform(prefix.begin(), prefix.end(), prefix.begin(), [](char c) {
+		return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	});
+	std::vector<std::string> matches;
+	const PrefixTrie &names = m_commands.names();
+	if (names.complete(prefix, matches, 64) == 0)
+		return;
+	std::string completion =
+		matches.size() == 1 ? matches[0] + " " : names.commonPrefix(prefix);
+	if (completion.size() > prefix.size()) {
+		data->DeleteChars(0, data->CursorPos);
+		data->InsertChars(0, completion.c_str());
+		return;
+	}
+	// Nothing left to add: list the candidates
+	std::string list;
+	for (const std::string &match : matches)
+		list += match + "  ";
+	addLog(list);
+	m_scrollToBottom = true;
+}
+
+void TerminalWindow::browseHistory(ImGuiInputTextCallbackData *data) {
+	const std::string text(data->Buf, static_cast<size_t>(data->BufTextLen));
+	// Edited since the last step: search again with the line as prefix
+	if (m_historyPos >= 0 &&
+		(m_historyPos >= static_cast<int>(m_historyMatches.size()) ||
+		 text != m_historyMatches[m_historyPos])) {
+		m_historyPos = -1;
+	}
+	if (m_historyPos < 0) {
+		m_historyPrefix = text;
+		m_historyMatches.clear();
+		m_historyTrie.complete(m_historyPrefix, m_historyMatches);
+		std::sort(m_historyMatches.begin(), m_historyMatches.end(),
+				  [this](const std::string &a, const std::string &b) {
+					  return m_historyLastUse[a] > m_historyLastUse[b];
+				  });
+	}
+	if (m_historyMatches.empty())
+		return;
+	const int last = static_cast<int>(m_historyMatches.size()) - 1;
+	if (data->EventKey == ImGuiKey_UpArrow)
+		m_historyPos = (std::min)(m_historyPos + 1, last);
+	else if (data->EventKey == ImGuiKey_DownArrow)
+		m_historyPos = (std::max)(m_historyPos - 1, -1);
+	const std::string &entry =
+		m_historyPos >= 0 ? m_historyMatches[m_historyPos] : m_historyPrefix;
+	data->DeleteChars(0, data->BufTextLen);
+	data->InsertChars(0, entry.c_str());
+}
+
+void TerminalWindow::addHistory(const std::string &command) {
+	m_historyPos = -1;
+	if (!m_commandHistory.empty() && m_commandHistory.back().second == command)
+		return;
+	const uint64_t id = m_historyCounter++;
+	m_commandHistory.emplace_back(id, command);
+	m_historyTrie.insert(command);
+	m_historyLastUse[command] = id;
+	if (m_commandHistory.size() > kMaxCommandHistory) {
+		// Drop the oldest entry from the index unless it was entered again
+		const auto &oldest = m_commandHistory.front();
+		auto it = m_historyLastUse.find(oldest.second);
+		if (it != m_historyLastUse.end() && it->second == oldest.first) {
+			m_historyTrie.erase(oldest.second);
+			m_historyLastUse.erase(it);
+		}
+		m_commandHistory.pop_front();
+	}
+}
+
 void TerminalWindow::processCommand(const std::string &command) {
-	std::string cmd = command;
-	std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
-
-	if (cmd == "help" || cmd == "h") {
-		addLog("Available commands:");
-		addLog("  help, h     - Show this help");
-		addLog("  clear, cls  - Clear terminal");
-		addLog("  version     - Show version info");
-		addLog("  echo <text> - Echo text");
-	} else if (cmd == "clear" || cmd == "cls") {
-		clearLog();
-	} else if (cmd == "version") {
-		addLog("Blot Terminal v1.0.0");
-	} else if (cmd.substr(0, 4) == "echo") {
-		std::string text = command.substr(4);
-		if (!text.empty() && text[0] == ' ') {
-			text = text.substr(1);
-		}
-		addLog(text);
-	} else {
-		addLog("Unknown command: '" + command +
-			   "'. Type 'help' for available commands.");
+	const Command *entry = nullptr;
+	std::vector<std::string> args;
+	std::string error;
+	if (!m_commands.parse(command, entry, args, error)) {
+		if (!entry && !error.empty()) {
+			addLog(error + ". Type 'help' for available commands.");
+		} else if (entry) {
+			addLog(error + ". Usage: " + entry->usage());
+		}
+		return;
 	}
+	m_runner.run(*entry, std::move(args));
+	// Commands run inline have already produced their output
+	update();
 }
 
 void TerminalWindow::addLog(const std::string &message) {
+	requestGlyphs(message.data(), message.data() + message.size());
 	m_logHistory.push_back(message);
 
 	// Limit log history to prevent memory issues
 	if (m_logHistory.size() > 1000) {
-		m_logHistory.erase(m_logHistory.begin());
+		m_logHistory.pop_front();
 	}
 }
 
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <deque>
 #include <imgui.h>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include "CommandRegistry.h"
+#include "PtyProcess.h"
+#include "TerminalScreen.h"
 #include "Window.h"
 
 namespace blot {
@@ -11,23 +17,84 @@ class TerminalWindow : public Window {
   public:
 	TerminalWindow(const std::string &title = "Terminal###Terminal",
 				   Flags flags = Flags::None);
-	virtual ~TerminalWindow() = default;
+	virtual ~TerminalWindow();
 
 	// Terminal functionality
 	void addLog(const std::string &message);
 	void clearLog();
 	void executeCommand(const std::string &command);
+	void update() override;
 	void renderContents() override;
 
+	// Console commands. Addons register theirs here; Async handlers run on
+	// a worker thread and their output streams into the console over the
+	// following frames. Ctrl+C in the input cancels the running command.
+	CommandRegistry &getCommands() { return m_commands; }
+	bool isCommandRunning() const { return m_runner.isBusy(); }
+	void cancelCommand();
+
+	// Shell mode (opt-in): run the user's shell, or command, on a pseudo
+	// terminal and show its screen instead of the built-in console. Output
+	// is parsed on the pty reader thread; frames only copy dirty rows.
+	// Returns false (with the reason in the console) where ptys are missing.
+	bool startShell(const std::string &command = "");
+	void stopShell();
+	bool isShellMode() const { return m_shellMode; }
+
   private:
-	std::vector<std::string> m_logHistory;
+	std::deque<std::string> m_logHistory;
 	char m_inputBuffer[1024] = {0};
 	bool m_scrollToBottom = true;
 
+	// Shell mode. m_screen is fed by the pty reader thread under
+	// m_screenMutex; the UI works on m_rowCache, a copy of the screen rows
+	// refreshed only where rows are dirty.
+	bool m_shellMode = false;
+	PtyProcess m_pty;
+	std::mutex m_screenMutex;
+	TerminalScreen m_screen;
+	std::vector<TerminalScreen::Cell> m_rowCache;
+	std::vector<TerminalScreen::Cell> m_lineScratch; // scrollback rows
+	int m_cacheCols = 0;
+	int m_cacheRows = 0;
+	size_t m_scrollbackSize = 0;
+	uint64_t m_scrollbackPushed = 0;
+	int m_cursorX = 0;
+	int m_cursorY = 0;
+	bool m_cursorVisible = true;
+	bool m_applicationCursor = false;
+	bool m_bracketedPaste = false;
+	bool m_followOutput = true;
+	std::string m_keyInput;
+
+	// Console commands and input history. m_historyTrie indexes the
+	// distinct entries for prefix search; m_historyLastUse orders matches.
+	CommandRegistry m_commands;
+	std::vector<CommandRunner::Output> m_outputScratch;
+	std::deque<std::pair<uint64_t, std::string>> m_commandHistory;
+	PrefixTrie m_historyTrie;
+	std::unordered_map<std::string, uint64_t> m_historyLastUse;
+	uint64_t m_historyCounter = 0;
+	std::vector<std::string> m_historyMatches; // newest first
+	int m_historyPos = -1;
+	std::string m_historyPrefix;
+	// Last member: joined first, while everything its handlers use is alive
+	CommandRunner m_runner;
+
 	// Terminal methods
 	void renderInput();
 	void renderLogHistory();
 	void processCommand(const std::string &command);
+	void registerBuiltinCommands();
+	void addHistory(const std::string &command);
+	static int inputCallback(ImGuiInputTextCallbackData *data);
+	void completeInput(ImGuiInputTextCallbackData *data);
+	void browseHistory(ImGuiInputTextCallbackData *data);
+	void renderShell();
+	void syncScreen();
+	void drawShellRow(ImDrawList *drawList, const TerminalScreen::Cell *cells,
+					  int cols, ImVec2 pos, float cellWidth, float lineHeight);
+	bool sendShellInput();
 };
 
 } // namespace blot
@@ -48,9 +48,9 @@ bool TextureViewerWindow::isMouseInsideTexture() const {
 
 ImVec2 TextureViewerWindow::getTextureSize() const { return m_textureSize; }
 
-std::string TextureViewerWindow::getName() const { return m_title; }
+const std::string &TextureViewerWindow::getName() const { return m_title; }
 
-std::string TextureViewerWindow::getTitle() const { return m_title; }
+const std::string &TextureViewerWindow::getTitle() const { return m_title; }
 
 void TextureViewerWindow::renderContents() {
 	drawTexture();
@@ -19,8 +19,8 @@ class TextureViewerWindow : public ImGuiWindow {
 	ImVec2 getTextureMousePos() const;
 	bool isMouseInsideTexture() const;
 	ImVec2 getTextureSize() const;
-	std::string getName() const;
-	std::string getTitle() const;
+	const std::string &getName() const;
+	const std::string &getTitle() const;
 	void renderContents() override;
 
   private:
@@ -176,8 +176,9 @@ void ToolbarWindow::renderSwatches() {
 		if (i > 0 && i % swatchesPerRow == 0)
 			ImGui::NewLine();
 
+		ImGui::PushID(i);
 		if (ImGui::ColorButton(
-				("##swatch" + std::to_string(i)).c_str(), m_swatches[i],
+				"##swatch", m_swatches[i],
 				ImGuiColorEditFlags_NoTooltip | ImGuiColorEditFlags_NoDragDrop,
 				ImVec2(24, 24))) {
 			if (m_activeSwatchType == 0) {
@@ -192,6 +193,7 @@ void ToolbarWindow::renderSwatches() {
 				}
 			}
 		}
+		ImGui::PopID();
 
 		ImGui::SameLine();
 	}
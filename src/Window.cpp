@@ -1,9 +1,199 @@
 #include "Window.h"
+#include <cstdint>
 #include <imgui.h>
+#include <imgui_internal.h>
 
 namespace blot {
 
-// Base Window class implementations (if any)
-// Most Window methods are pure virtual and implemented in derived classes
+namespace {
+
+// Identifies the font atlas texture and its size
+void fontTextureState(ImU64 &texture, int &width, int &height) {
+	const ImFontAtlas *atlas = ImGui::GetIO().Fonts;
+#if IMGUI_VERSION_NUM >= 19200
+	const ImTextureData *data = atlas->TexData;
+	texture = data ? static_cast<ImU64>(data->UniqueID) : 0;
+	width = data ? data->Width : 0;
+	height = data ? data->Height : 0;
+#else
+	texture = (ImU64)(uintptr_t)atlas->TexID;
+	width = atlas->TexWidth;
+	height = atlas->TexHeight;
+#endif
+}
+
+} // namespace
+
+void Window::render() {
+	if (!m_isOpen)
+		return;
+	if (m_focusRequested) {
+		ImGui::SetNextWindowFocus();
+		m_focusRequested = false;
+	}
+	if (ImGui::Begin(m_title.c_str(), &m_isOpen, m_flags)) {
+		if (m_updatePolicy == UpdatePolicy::EveryFrame || m_snapshotUnsupported)
+			renderContents();
+		else
+			renderWithSnapshot();
+	} else {
+		// Collapsed or fully clipped: the captured layout is no longer valid
+		m_snapshot.valid = false;
+	}
+	ImGui::End();
+}
+
+bool Window::needsRebuild() const {
+	if (!m_snapshot.valid)
+		return true;
+	// Anything the user interacts with runs at full rate
+	if (ImGui::IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows) ||
+		ImGui::IsWindowHovered(ImGuiHoveredFlags_ChildWindows |
+							   ImGuiHoveredFlags_AllowWhenBlockedByActiveItem))
+		return true;
+	const ::ImGuiWindow *window = ImGui::GetCurrentWindowRead();
+	if (window->Size.x != m_snapshot.windowSize.x ||
+		window->Size.y != m_snapshot.windowSize.y ||
+		window->Scroll.x != m_snapshot.scroll.x ||
+		window->Scroll.y != m_snapshot.scroll.y)
+		return true;
+	ImU64 fontTexture = 0;
+	int fontTexWidth = 0, fontTexHeight = 0;
+	fontTextureState(fontTexture, fontTexWidth, fontTexHeight);
+	if (fontTexture != m_snapshot.fontTexture ||
+		fontTexWidth != m_snapshot.fontTexWidth ||
+		fontTexHeight != m_snapshot.fontTexHeight)
+		return true;
+	if (m_updatePolicy == UpdatePolicy::Throttled) {
+		double interval = m_updateRateHz > 0.0f ? 1.0 / m_updateRateHz : 0.0;
+		return ImGui::GetTime() - m_snapshot.captureTime >= interval;
+	}
+	return false;
+}
+
+void Window::renderWithSnapshot() {
+	if (!needsRebuild()) {
+		replaySnapshot();
+		return;
+	}
+
+	::ImGuiWindow *window = ImGui::GetCurrentWindow();
+	ImDrawList *drawList = window->DrawList;
+	// The current command may already hold the window background; contents
+	// start at the current index position within it
+	const int cmdStart = drawList->CmdBuffer.Size - 1;
+	const int vtxStart = drawList->VtxBuffer.Size;
+	const int idxStart = drawList->IdxBuffer.Size;
+	const ImVec2 cursorStart = window->DC.CursorStartPos;
+	// Read before drawing: should the atlas grow mid-frame, the next frame
+	// sees the change and rebuilds
+	fontTextureState(m_snapshot.fontTexture, m_snapshot.fontTexWidth,
+					 m_snapshot.fontTexHeight);
+
+	renderContents();
+
+	// Child windows have their own draw lists we do not capture
+	if (window->DC.ChildWindows.Size > 0 ||
+		!captureSnapshot(cmdStart, vtxStart, idxStart)) {
+		m_snapshotUnsupported = true;
+		m_snapshot.valid = false;
+		return;
+	}
+	m_snapshot.windowPos = window->Pos;
+	m_snapshot.windowSize = window->Size;
+	m_snapshot.scroll = window->Scroll;
+	m_snapshot.contentSize = ImVec2(window->DC.CursorMaxPos.x - cursorStart.x,
+									window->DC.CursorMaxPos.y - cursorStart.y);
+	m_snapshot.captureTime = ImGui::GetTime();
+	m_snapshot.valid = true;
+}
+
+bool Window::captureSnapshot(int cmdStart, int vtxStart, int idxStart) {
+	const ImDrawList *drawList = ImGui::GetWindowDrawList();
+	m_snapshot.vertices.resize(0);
+	m_snapshot.indices.resize(0);
+	m_snapshot.commands.resize(0);
+
+	for (int i = cmdStart; i < drawList->CmdBuffer.Size; i++) {
+		const ImDrawCmd &cmd = drawList->CmdBuffer[i];
+		if (cmd.UserCallback != nullptr)
+			return false;
+		const int begin = ImMax((int)cmd.IdxOffset, idxStart);
+		const int end = (int)(cmd.IdxOffset + cmd.ElemCount);
+		if (end <= begin)
+			continue;
+
+		// Vertex range referenced by this command's indices
+		unsigned int vtxMin = UINT_MAX, vtxMax = 0;
+		for (int n = begin; n < end; n++) {
+			unsigned int v = cmd.VtxOffset + drawList->IdxBuffer[n];
+			vtxMin = ImMin(vtxMin, v);
+			vtxMax = ImMax(vtxMax, v);
+		}
+		if ((int)vtxMin < vtxStart)
+			return false;
+
+		DrawSnapshot::Command out;
+		out.clipRect = cmd.ClipRect;
+#if IMGUI_VERSION_NUM >= 19200
+		out.texture = cmd.TexRef;
+#else
+		out.textureId = cmd.GetTexID();
+#endif
+		out.vtxStart = m_snapshot.vertices.Size;
+		out.vtxCount = (int)(vtxMax - vtxMin + 1);
+		out.idxStart = m_snapshot.indices.Size;
+		out.idxCount = end - begin;
+		for (unsigned int v = vtxMin; v <= vtxMax; v++)
+			m_snapshot.vertices.push_back(drawList->VtxBuffer[v]);
+		for (int n = begin; n < end; n++)
+			m_snapshot.indices.push_back(cmd.VtxOffset +
+										 drawList->IdxBuffer[n] - vtxMin);
+		m_snapshot.commands.push_back(out);
+	}
+	return true;
+}
+
+void Window::replaySnapshot() {
+	::ImGuiWindow *window = ImGui::GetCurrentWindow();
+	ImDrawList *drawList = window->DrawList;
+	const ImVec2 delta(window->Pos.x - m_snapshot.windowPos.x,
+					   window->Pos.y - m_snapshot.windowPos.y);
+
+	for (const DrawSnapshot::Command &cmd : m_snapshot.commands) {
+		drawList->PushClipRect(
+			ImVec2(cmd.clipRect.x + delta.x, cmd.clipRect.y + delta.y),
+			ImVec2(cmd.clipRect.z + delta.x, cmd.clipRect.w + delta.y));
+#if IMGUI_VERSION_NUM >= 19200
+		drawList->PushTexture(cmd.texture);
+#else
+		drawList->PushTextureID(cmd.textureId);
+#endif
+		drawList->PrimReserve(cmd.idxCount, cmd.vtxCount);
+		const ImDrawIdx base = (ImDrawIdx)drawList->_VtxCurrentIdx;
+		for (int i = 0; i < cmd.vtxCount; i++) {
+			ImDrawVert v = m_snapshot.vertices[cmd.vtxStart + i];
+			v.pos.x += delta.x;
+			v.pos.y += delta.y;
+			drawList->_VtxWritePtr[i] = v;
+		}
+		for (int i = 0; i < cmd.idxCount; i++) {
+			drawList->_IdxWritePtr[i] =
+				(ImDrawIdx)(base + m_snapshot.indices[cmd.idxStart + i]);
+		}
+		drawList->_VtxWritePtr += cmd.vtxCount;
+		drawList->_IdxWritePtr += cmd.idxCount;
+		drawList->_VtxCurrentIdx += cmd.vtxCount;
+#if IMGUI_VERSION_NUM >= 19200
+		drawList->PopTexture();
+#else
+		drawList->PopTextureID();
+#endif
+		drawList->PopClipRect();
+	}
+
+	// Keep the content size so scrollbars and auto-resize stay stable
+	ImGui::Dummy(m_snapshot.contentSize);
+}
 
 } // namespace blot
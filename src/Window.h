@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <imgui.h>
 #include <string>
 
@@ -34,6 +35,14 @@ class Window {
 		ChildMenu = ImGuiWindowFlags_ChildMenu
 	};
 
+	// How often renderContents() runs. EveryFrame is the default. Throttled
+	// windows rebuild at most getUpdateRate() times per second while they
+	// are not focused or hovered; Static windows rebuild only after
+	// invalidate(). Frames in between replay a captured copy of the window's
+	// draw commands. Windows whose contents open child windows or use draw
+	// callbacks cannot be replayed and fall back to EveryFrame.
+	enum class UpdatePolicy { EveryFrame, Throttled, Static };
+
 	Window(const std::string &title, Flags flags = Flags::None)
 		: m_title(title), m_flags(static_cast<int>(flags)) {}
 	virtual ~Window() = default;
@@ -50,8 +59,8 @@ class Window {
 	bool isFocused() const { return m_isFocused; }
 
 	// Window identification
-	std::string getName() const { return m_title; }
-	std::string getTitle() const { return m_title; }
+	const std::string &getName() const { return m_title; }
+	const std::string &getTitle() const { return m_title; }
 
 	// Flags
 	void setFlags(Flags flags) { m_flags = static_cast<int>(flags); }
@@ -71,8 +80,37 @@ class Window {
 	ImVec2 getMaxSize() const { return m_maxSize; }
 	float getAlpha() const { return m_alpha; }
 
+	// Update-rate policy
+	void setUpdatePolicy(UpdatePolicy policy, float rateHz = 10.0f) {
+		m_updatePolicy = policy;
+		m_updateRateHz = rateHz;
+		m_snapshotUnsupported = false;
+		invalidate();
+	}
+	UpdatePolicy getUpdatePolicy() const { return m_updatePolicy; }
+	float getUpdateRate() const { return m_updateRateHz; }
+	// Drop the captured draw commands so the next frame rebuilds them
+	void invalidate() {
+		m_snapshot.valid = false;
+		requestRedraw();
+	}
+
 	// Focus management
 	void setFocused(bool focused) { m_isFocused = focused; }
+	// Focus and bring to front in ImGui the next time the window renders
+	void requestFocus() { m_focusRequested = true; }
+
+	// Ask the UI to build the next frame even if idle mode would skip it.
+	// Safe to call from any thread (e.g. log sinks, worker callbacks).
+	void requestRedraw() {
+		m_redrawRequested.store(true, std::memory_order_relaxed);
+	}
+	bool hasRedrawRequest() const {
+		return m_redrawRequested.load(std::memory_order_relaxed);
+	}
+	bool consumeRedrawRequest() {
+		return m_redrawRequested.exchange(false, std::memory_order_relaxed);
+	}
 
 	// Helper method for windows to update focus state during rendering
 	void updateFocusState() {
@@ -88,14 +126,11 @@ class Window {
 
 	// Non-virtual render: handles ImGui::Begin/End and open/close logic
 	// automatically
-	void render() {
-		if (!m_isOpen)
-			return;
-		if (ImGui::Begin(m_title.c_str(), &m_isOpen, m_flags)) {
-			renderContents();
-		}
-		ImGui::End();
-	}
+	void render();
+
+	// Called by MWindow once per frame before rendering, even for hidden
+	// windows; for work that must not stall while the window is closed
+	virtual void update() {}
 
   protected:
 	// Derived classes implement only the window's UI here
@@ -110,7 +145,52 @@ class Window {
 	ImVec2 m_minSize = ImVec2(100, 100);
 	ImVec2 m_maxSize = ImVec2(FLT_MAX, FLT_MAX);
 	bool m_isFocused = false;
+	bool m_focusRequested = false;
 	float m_alpha = 1.0f;
+	std::atomic<bool> m_redrawRequested{false};
+
+  private:
+	// Draw commands emitted by renderContents(), replayed on frames where the
+	// update policy skips rebuilding. Buffers keep their capacity, so steady
+	// state capture/replay does not allocate.
+	struct DrawSnapshot {
+		struct Command {
+			ImVec4 clipRect;
+#if IMGUI_VERSION_NUM >= 19200
+			// Keeps the link to the atlas ImTextureData, whose TexID may not
+			// be assigned yet (first frame, headless)
+			ImTextureRef texture;
+#else
+			ImTextureID textureId;
+#endif
+			int vtxStart, vtxCount;
+			int idxStart, idxCount;
+		};
+		ImVector<ImDrawVert> vertices;
+		ImVector<unsigned int> indices; // relative to Command::vtxStart
+		ImVector<Command> commands;
+		ImVec2 windowPos;
+		ImVec2 windowSize;
+		ImVec2 scroll;
+		ImVec2 contentSize;
+		double captureTime = 0.0;
+		// The font texture the vertices' UVs point into; a new or resized
+		// one invalidates them
+		ImU64 fontTexture = 0;
+		int fontTexWidth = 0;
+		int fontTexHeight = 0;
+		bool valid = false;
+	};
+
+	UpdatePolicy m_updatePolicy = UpdatePolicy::EveryFrame;
+	float m_updateRateHz = 10.0f;
+	DrawSnapshot m_snapshot;
+	bool m_snapshotUnsupported = false;
+
+	void renderWithSnapshot();
+	bool needsRebuild() const;
+	bool captureSnapshot(int cmdStart, int vtxStart, int idxStart);
+	void replaySnapshot();
 };
 
 // Utility function to combine flags
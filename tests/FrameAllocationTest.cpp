@@ -0,0 +1,51 @@
+// Runs Mui on the headless backend with its default windows and fails when
+// a steady frame (no input, no new log lines) allocates anything, through
+// ImGui or the global operator new.
+#include <cstdio>
+#include "AllocationCounter.h"
+#include "Mui.h"
+
+int main(int, char **) {
+	// Without the operator new hook only ImGui's allocator is counted, and
+	// std::string/vector traffic on the hot path would go unnoticed
+	if (!blot::AllocationCounter::isOperatorNewHooked()) {
+		std::fprintf(stderr, "operator new is not hooked; build with "
+							 "BXIMGUI_COUNT_ALLOCATIONS\n");
+		return 1;
+	}
+
+	// Fonts, window creation and the first layouts allocate; so may the
+	// throttled panels' first snapshot captures
+	constexpr int kWarmupFrames = 120;
+	constexpr int kSteadyFrames = 600;
+
+	blot::Mui mui(nullptr, blot::Mui::Backend::Headless);
+	// Nothing written to the user's cache directories
+	mui.setFontCacheDirectory("");
+	mui.setLogSpillDirectory("");
+	mui.init();
+	mui.setupWindows(nullptr);
+
+	for (int i = 0; i < kWarmupFrames; i++) {
+		mui.update();
+	}
+	const uint64_t warmupAllocating = mui.getFrameStats().allocatingFrames;
+	for (int i = 0; i < kSteadyFrames; i++) {
+		mui.update();
+	}
+
+	const blot::Mui::FrameStats &stats = mui.getFrameStats();
+	const uint64_t allocating = stats.allocatingFrames - warmupAllocating;
+	if (allocating > 0) {
+		std::fprintf(stderr,
+					 "%llu of %d steady frames allocated (last: %llu "
+					 "allocations, %llu bytes)\n",
+					 static_cast<unsigned long long>(allocating), kSteadyFrames,
+					 static_cast<unsigned long long>(stats.lastFrameAllocations),
+					 static_cast<unsigned long long>(
+						 stats.lastFrameAllocatedBytes));
+		return 1;
+	}
+	std::printf("%d steady frames, none allocated\n", kSteadyFrames);
+	return 0;
+}